@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 운영 알림 엔진
+Author: Manus AI
+Date: 2025-09-26
+
+발송 채널별・정보원별 성공/실패를 메모리 내 슬라이딩 윈도우로 집계하고,
+기록 시점에 해당 키만 판정한다 (DB 조회 없음).
+- 발화 중인 알림은 해소될 때까지 재발송하지 않음 (중복 제거)
+- 같은 알림은 마지막 발송 후 쿨다운 동안 억제
+"""
+
+import os
+import logging
+import threading
+from typing import Callable, Dict, List, Optional, Tuple
+
+import pytz
+
+import clock
+
+logger = logging.getLogger(__name__)
+
+JST = pytz.timezone('Asia/Tokyo')
+
+# 알림 발송 함수: (제목, 본문) -> 성공 여부
+AlertSink = Callable[[str, str], bool]
+
+
+class SlidingWindowCounter:
+    """고정 폭 버킷 링으로 구현한 슬라이딩 윈도우 합계 (기록・조회 모두 상각 O(1))"""
+
+    def __init__(self, window_seconds: float, bucket_seconds: float):
+        self.bucket_seconds = bucket_seconds
+        self.size = max(1, int(-(-window_seconds // bucket_seconds)))
+        self.buckets = [0] * self.size
+        self.head: Optional[int] = None  # 마지막으로 진행한 버킷 번호
+        self.total = 0
+
+    def _advance(self, now: float) -> int:
+        index = int(now // self.bucket_seconds)
+        if self.head is None:
+            self.head = index
+        elif index > self.head:
+            # 윈도우 밖으로 밀려난 버킷만 차감
+            for step in range(1, min(index - self.head, self.size) + 1):
+                slot = (self.head + step) % self.size
+                self.total -= self.buckets[slot]
+                self.buckets[slot] = 0
+            self.head = index
+        return self.head % self.size
+
+    def add(self, now: float, amount: int = 1):
+        self.buckets[self._advance(now)] += amount
+        self.total += amount
+
+    def value(self, now: float) -> int:
+        self._advance(now)
+        return self.total
+
+
+class Alert:
+    def __init__(self, fingerprint: Tuple, subject: str, message: str):
+        self.fingerprint = fingerprint
+        self.subject = subject
+        self.message = message
+        self.raised_at = clock.now(JST)
+
+
+class AlertEngine:
+    """채널・정보원 단위 실패율 알림 (임계값・중복 제거・쿨다운)"""
+
+    def __init__(self, sinks: Optional[List[Tuple[str, AlertSink]]] = None):
+        self.window_seconds = float(os.getenv('ALERT_WINDOW_SECONDS', '3600'))
+        self.bucket_seconds = float(os.getenv('ALERT_BUCKET_SECONDS', '60'))
+        self.min_failures = int(os.getenv('ALERT_MIN_FAILURES', '3'))
+        self.failure_ratio = float(os.getenv('ALERT_FAILURE_RATIO', '0.5'))
+        self.cooldown_seconds = float(os.getenv('ALERT_COOLDOWN_SECONDS', '3600'))
+        self.sinks = sinks or []
+
+        self._counters: Dict[Tuple[str, str], Tuple[SlidingWindowCounter, SlidingWindowCounter]] = {}
+        self._firing: Dict[Tuple, Alert] = {}
+        self._last_sent: Dict[Tuple, float] = {}
+        self._pending: List[Alert] = []
+        self.suppressed = 0
+        self._lock = threading.Lock()
+
+    def record(self, dimension: str, key: str, ok: bool, now: Optional[float] = None):
+        """결과 1건 기록 후 해당 키만 판정 (dimension: 'channel' | 'source')"""
+        now = clock.time() if now is None else now
+        with self._lock:
+            counters = self._counters.get((dimension, key))
+            if counters is None:
+                counters = self._counters[(dimension, key)] = (
+                    SlidingWindowCounter(self.window_seconds, self.bucket_seconds),
+                    SlidingWindowCounter(self.window_seconds, self.bucket_seconds))
+            attempts, failures = counters
+            attempts.add(now)
+            if not ok:
+                failures.add(now)
+
+            failed, total = failures.value(now), attempts.value(now)
+            fingerprint = ('failure_rate', dimension, key)
+            breached = failed >= self.min_failures and failed >= self.failure_ratio * total
+            if breached and fingerprint not in self._firing:
+                minutes = self.window_seconds / 60
+                alert = Alert(fingerprint,
+                              f"【運用アラート】{dimension}={key} の失敗率上昇",
+                              f"直近{minutes:.0f}分: 失敗 {failed}件 / 全 {total}件 ({failed / total:.0%})")
+                self._firing[fingerprint] = alert
+                self._enqueue(alert, now)
+            elif not breached and fingerprint in self._firing:
+                del self._firing[fingerprint]
+                logger.info(f"アラート解消: {dimension}={key} (失敗 {failed}/{total})")
+
+    def raise_alert(self, key: str, subject: str, message: str, now: Optional[float] = None):
+        """단발성 장애 알림 (같은 key는 쿨다운 동안 1회만)"""
+        now = clock.time() if now is None else now
+        with self._lock:
+            self._enqueue(Alert(('event', key), subject, message), now)
+
+    def _enqueue(self, alert: Alert, now: float):
+        last_sent = self._last_sent.get(alert.fingerprint)
+        if last_sent is not None and now - last_sent < self.cooldown_seconds:
+            self.suppressed += 1
+            logger.info(f"アラート抑制 (クールダウン中): {alert.subject}")
+            return
+        self._last_sent[alert.fingerprint] = now
+        self._pending.append(alert)
+
+    def flush(self, dry_run: bool = False) -> int:
+        """대기 중인 알림 발송 (잠금 밖에서 발송) → 발송한 알림 수"""
+        with self._lock:
+            pending, self._pending = self._pending, []
+
+        for alert in pending:
+            body = f"{alert.message}\n\n発生時刻: {alert.raised_at.strftime('%Y-%m-%d %H:%M:%S')}"
+            logger.critical(f"{alert.subject}\n{body}")
+            if dry_run or not self.sinks:
+                continue
+            for name, sink in self.sinks:
+                try:
+                    if not sink(alert.subject, body):
+                        logger.error(f"アラート送信失敗 ({name}): {alert.subject}")
+                except Exception as e:
+                    logger.error(f"アラート送信エラー ({name}): {str(e)}")
+        return len(pending)
+
+    def firing(self) -> List[Dict]:
+        with self._lock:
+            return [{'fingerprint': list(alert.fingerprint), 'subject': alert.subject,
+                     'raised_at': alert.raised_at.isoformat()} for alert in self._firing.values()]
+
+    def metrics(self, labels: str = '') -> List[str]:
+        """Prometheus 텍스트 형식 (labels 예: '{tenant="kanto"}')"""
+        with self._lock:
+            firing, suppressed = len(self._firing), self.suppressed
+        return [
+            '# HELP seminar_alerts_firing Failure-rate alerts currently firing',
+            '# TYPE seminar_alerts_firing gauge',
+            f'seminar_alerts_firing{labels} {firing}',
+            '# HELP seminar_alerts_suppressed_total Alerts suppressed by cooldown',
+            '# TYPE seminar_alerts_suppressed_total counter',
+            f'seminar_alerts_suppressed_total{labels} {suppressed}',
+        ]
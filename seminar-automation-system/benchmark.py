@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 항목 단위 헬퍼 마이크로 벤치마크
+Author: Manus AI
+Date: 2025-09-26
+
+페이지의 앵커마다 1회씩 호출되는 추출・판정 헬퍼의 호출당 비용과 그 분포를 측정하고,
+저장된 기준값(benchmarks/baseline.json)과 비교해 회귀를 검출한다.
+기준값은 측정 환경에 의존하므로 저장소에 포함하지 않는다 (조용한 머신이나 CI 에서 --save 로 생성).
+- 입력: benchmarks/corpus.json (실제 지방운수국 제목・水路通報 문장・날짜 문자열)
+- 측정: 입력 1건마다 inner 회 연속 호출한 평균을 1표본으로 하고, rounds 회 반복한 표본의 분포
+- 비교: 입력별 최솟값의 중앙값(typical)을 고정 워크로드(calibration)로 측정기 속도 차이를 보정해
+  기준값과 비교하고, 허용치를 넘게 느려지면 실패 (종료 코드 1)
+- 컴파일판: extraction/gazetteer 의 mypyc 컴파일판이 있으면 그것을 측정. --compare-pure 는 순수 Python 판
+  (BENCH_PURE=1 로 소스에서 로드)을 별도 프로세스로 측정해 속도 향상과 출력 일치를 확인
+
+사용 예:
+    python benchmark.py                    # 측정 후 기준값과 비교
+    python benchmark.py --save             # 기준값 갱신 (규칙 변경을 의도적으로 반영할 때)
+    python benchmark.py --save --baseline base.json   # CI: 기준 커밋에서 저장 → 같은 러너에서 비교
+    python benchmark.py --only detect_status,extract_location --rounds 50
+    python benchmark.py --compare-pure     # 컴파일판과 순수 Python 판 비교 (출력이 다르면 실패)
+"""
+
+import os
+import sys
+import json
+import time
+import hashlib
+import argparse
+import platform
+import tempfile
+import subprocess
+from datetime import datetime
+from pathlib import Path
+from typing import Callable, Dict, List, Sequence, Tuple
+
+import pytz
+
+APP_DIR = str(Path(__file__).resolve().parent)
+
+if os.getenv('BENCH_PURE', '').lower() in ('1', 'true', 'yes'):
+    # 컴파일판(.so)이 있어도 이 디렉터리의 모듈은 소스에서 로드 (확장 모듈 로더를 뺀 FileFinder)
+    from importlib.machinery import SOURCE_SUFFIXES, FileFinder, SourceFileLoader
+    for entry in [APP_DIR] + [path for path in sys.path if os.path.realpath(path or '.') == APP_DIR]:
+        sys.path_importer_cache[entry] = FileFinder(entry, (SourceFileLoader, SOURCE_SUFFIXES))
+
+import clock
+import extraction
+from seminar_automation_system import SeminarAutomationSystem
+from seminar_config import SeminarConfig
+
+JST = pytz.timezone('Asia/Tokyo')
+
+BENCH_DIR = Path(__file__).resolve().parent / 'benchmarks'
+CORPUS_PATH = BENCH_DIR / 'corpus.json'
+BASELINE_PATH = BENCH_DIR / 'baseline.json'
+
+DIGEST_TIME = JST.localize(datetime(2025, 10, 1, 9, 0))
+
+
+def percentile(sorted_values: Sequence[float], ratio: float) -> float:
+    return sorted_values[min(len(sorted_values) - 1, int(len(sorted_values) * ratio))]
+
+
+def measure(fn: Callable, inputs: Sequence, rounds: int, inner: int) -> Dict[str, float]:
+    """호출당 소요 시간(ns) 분포"""
+    for value in inputs:  # 워밍업 (정규식 컴파일 캐시 등)
+        fn(value)
+
+    samples = []
+    best = [float('inf')] * len(inputs)  # 입력별 최솟값 (다른 프로세스의 간섭을 제거한 비용)
+    for _ in range(rounds):
+        for index, value in enumerate(inputs):
+            started = time.perf_counter_ns()
+            for _ in range(inner):
+                fn(value)
+            elapsed = (time.perf_counter_ns() - started) / inner
+            samples.append(elapsed)
+            best[index] = min(best[index], elapsed)
+
+    samples.sort()
+    best.sort()
+    return {
+        'calls': len(samples) * inner,
+        'min_ns': round(samples[0], 1),
+        'typical_ns': round(percentile(best, 0.50), 1),
+        'mean_ns': round(sum(samples) / len(samples), 1),
+        'p50_ns': round(percentile(samples, 0.50), 1),
+        'p95_ns': round(percentile(samples, 0.95), 1),
+        'p99_ns': round(percentile(samples, 0.99), 1),
+        'max_ns': round(samples[-1], 1),
+    }
+
+
+def calibration_workload(_):
+    # 측정기 속도 보정용 고정 워크로드 (문자열 처리 + 정수 연산)
+    text = '海技者セミナー参加者募集'
+    total = 0
+    for i in range(200):
+        total += len(text[i % 10:]) * i
+    return total
+
+
+def load_helpers(config_dir: str) -> SeminarAutomationSystem:
+    """DB・네트워크 없이 헬퍼만 사용할 수 있는 인스턴스 (헬퍼는 self.config 만 참조)"""
+    system = SeminarAutomationSystem.__new__(SeminarAutomationSystem)
+    system.config = SeminarConfig.load(config_dir)
+    return system
+
+
+def build_cases(system: SeminarAutomationSystem, corpus: Dict) -> List[Tuple[str, Callable, List]]:
+    texts = corpus['bureau_titles'] + corpus['waterway_texts']
+    seminars = []
+    for index, title in enumerate(corpus['bureau_titles']):
+        seminars.append({
+            'region': '관동',
+            'title': title,
+            'event_date': system.extract_date_from_text(title),
+            'location': system.extract_location(title),
+            'status': system.detect_status(title),
+            'source_url': f'https://example.jp/seminar/{index}.html',
+            'raw_text': title,
+        })
+    normalized = [system.normalize_seminar(seminar) for seminar in seminars]
+
+    return [
+        ('calibration', calibration_workload, [None] * 50),
+        ('contains_seminar_keywords', system.contains_seminar_keywords, texts),
+        ('detect_status', system.detect_status, texts),
+        ('extract_location', system.extract_location, texts),
+        ('extract_date_from_text', system.extract_date_from_text, texts),
+        ('parse_date', system.parse_date, corpus['date_strings']),
+        ('normalize_seminar', system.normalize_seminar, seminars),
+        ('is_important', system.is_important, normalized),
+    ]
+
+
+def outputs_digest(fn: Callable, inputs: Sequence) -> str:
+    """입력별 반환값의 요약 (컴파일판과 순수 Python 판의 출력 일치 확인용)"""
+    # 해석 실패 시의 현재 시각・월일만 있는 날짜의 연도가 실행마다 달라지지 않도록 시계 고정
+    system_clock = clock.current()
+    clock.install(clock.VirtualClock(DIGEST_TIME))
+    try:
+        digest = hashlib.sha1()
+        for value in inputs:
+            digest.update(repr(fn(value)).encode('utf-8'))
+        return digest.hexdigest()
+    finally:
+        clock.install(system_clock)
+
+
+def compare_pure(results: Dict[str, Dict], digests: Dict[str, str], args) -> List[str]:
+    """순수 Python 판을 별도 프로세스로 측정해 속도 향상 출력, 출력이 다른 벤치마크 목록 반환"""
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'pure.json')
+        command = [sys.executable, os.path.abspath(__file__), '--rounds', str(args.rounds), '--inner', str(args.inner),
+                   '--config-dir', args.config_dir, '--json', path, '--no-baseline']
+        if args.only:
+            command += ['--only', args.only]
+        subprocess.run(command, env={**os.environ, 'BENCH_PURE': '1'}, stdout=subprocess.DEVNULL, check=False)
+        with open(path, 'r', encoding='utf-8') as f:
+            pure = json.load(f)
+
+    mismatched = []
+    print(f"\n純Python版との比較 ({pure['implementation']} → {implementation()})")
+    for name, result in results.items():
+        base = pure['results'].get(name)
+        if name == 'calibration' or base is None:
+            continue
+        same = pure['outputs'].get(name) == digests.get(name)
+        if not same:
+            mismatched.append(name)
+        print(f"  {name:<28} {base['typical_ns']:>10.0f} → {result['typical_ns']:>10.0f} ns  "
+              f"x{base['typical_ns'] / result['typical_ns']:.2f}{'' if same else '  ← 出力不一致'}")
+    return mismatched
+
+
+def implementation() -> str:
+    return 'mypyc' if extraction.COMPILED else 'python'
+
+
+def compare(results: Dict[str, Dict], baseline: Dict, tolerance: float) -> List[str]:
+    """보정된 대표값(입력별 최솟값의 중앙값)이 기준값 대비 tolerance 를 넘게 느려진 벤치마크 목록"""
+    # 보정은 다른 프로세스의 간섭을 받기 어려운 최솟값 기준
+    scale = results['calibration']['min_ns'] / baseline['results']['calibration']['min_ns']
+    regressions = []
+    print(f"\n基準値との比較 (基準 {baseline['saved_at']}, 計測環境補正 x{scale:.2f}, 許容 +{tolerance:.0%})")
+    if baseline.get('implementation', 'python') != implementation():
+        print(f"  注意: 基準値は {baseline.get('implementation', 'python')} 版、今回は {implementation()} 版です")
+    for name, result in results.items():
+        base = baseline['results'].get(name)
+        if name == 'calibration' or base is None:
+            continue
+        ratio = result['typical_ns'] / (base['typical_ns'] * scale)
+        regressed = ratio > 1 + tolerance
+        if regressed:
+            regressions.append(name)
+        print(f"  {name:<28} {base['typical_ns'] * scale:>10.0f} → {result['typical_ns']:>10.0f} ns  "
+              f"{ratio - 1:+7.1%}{'  ← 回帰' if regressed else ''}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='抽出・判定ヘルパーのマイクロベンチマーク')
+    parser.add_argument('--rounds', type=int, default=int(os.getenv('BENCH_ROUNDS', '30')))
+    parser.add_argument('--inner', type=int, default=int(os.getenv('BENCH_INNER', '20')), help='1標本あたりの連続呼び出し回数')
+    parser.add_argument('--only', default='', help='対象ベンチマーク（カンマ区切り）')
+    parser.add_argument('--config-dir', default=os.getenv('CONFIG_DIR', str(Path(__file__).resolve().parent / 'config')))
+    parser.add_argument('--save', action='store_true', help='結果を基準値として保存')
+    parser.add_argument('--tolerance', type=float, default=float(os.getenv('BENCH_TOLERANCE', '0.5')),
+                        help='許容する代表値の悪化率')
+    parser.add_argument('--json', help='結果をJSONで出力するパス')
+    parser.add_argument('--compare-pure', action='store_true', help='純Python版と速度・出力を比較（コンパイル版が必要）')
+    parser.add_argument('--no-baseline', action='store_true', help='基準値と比較しない')
+    parser.add_argument('--baseline', default=os.getenv('BENCH_BASELINE', str(BASELINE_PATH)), help='基準値ファイル')
+    args = parser.parse_args()
+    if args.compare_pure and not extraction.COMPILED:
+        print("コンパイル版がありません（mypyc extraction.py gazetteer.py で生成）", file=sys.stderr)
+        sys.exit(2)
+
+    with open(CORPUS_PATH, 'r', encoding='utf-8') as f:
+        corpus = json.load(f)
+    system = load_helpers(args.config_dir)
+    only = {name for name in args.only.split(',') if name}
+
+    results, digests = {}, {}
+    print(f"実装: {implementation()}")
+    print(f"{'benchmark':<28} {'calls':>8} {'typical':>9} {'mean':>9} {'p50':>9} {'p95':>9} {'p99':>9} {'max':>9}  (ns/call)")
+    for name, fn, inputs in build_cases(system, corpus):
+        if only and name not in only and name != 'calibration':
+            continue
+        result = measure(fn, inputs, args.rounds, args.inner)
+        results[name] = result
+        digests[name] = outputs_digest(fn, inputs)
+        print(f"{name:<28} {result['calls']:>8} {result['typical_ns']:>9.0f} {result['mean_ns']:>9.0f} {result['p50_ns']:>9.0f} "
+              f"{result['p95_ns']:>9.0f} {result['p99_ns']:>9.0f} {result['max_ns']:>9.0f}")
+
+    report = {'saved_at': datetime.now(JST).isoformat(timespec='seconds'), 'python': platform.python_version(),
+              'machine': platform.machine(), 'implementation': implementation(),
+              'rounds': args.rounds, 'inner': args.inner, 'results': results}
+    if args.json:
+        with open(args.json, 'w', encoding='utf-8') as f:
+            json.dump({**report, 'outputs': digests}, f, ensure_ascii=False, indent=2)
+
+    if args.compare_pure:
+        mismatched = compare_pure(results, digests, args)
+        if mismatched:
+            print(f"\n出力不一致: {', '.join(mismatched)}", file=sys.stderr)
+            sys.exit(1)
+        return
+
+    baseline_path = Path(args.baseline)
+    if args.save:
+        if only:
+            print("--only 指定時は基準値を保存できません", file=sys.stderr)
+            sys.exit(2)
+        with open(baseline_path, 'w', encoding='utf-8') as f:
+            json.dump(report, f, ensure_ascii=False, indent=2)
+            f.write('\n')
+        print(f"\n基準値を保存しました: {baseline_path}")
+        return
+
+    if args.no_baseline:
+        return
+    if not baseline_path.exists():
+        print(f"\n基準値がありません（--save で作成）: {baseline_path}")
+        return
+    with open(baseline_path, 'r', encoding='utf-8') as f:
+        baseline = json.load(f)
+    regressions = compare(results, baseline, args.tolerance)
+    if regressions:
+        print(f"\n性能回帰: {', '.join(regressions)}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - sitemap lastmod / 조건부 GET 기반 변경 감지
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import logging
+import xml.etree.ElementTree as ET
+from urllib.parse import urlparse, urljoin
+from typing import Dict, Optional
+
+from fetcher import Fetcher
+from snapshot_diff import SnapshotStore, Validators
+import clock
+
+logger = logging.getLogger(__name__)
+
+SITEMAP_NS = '{http://www.sitemaps.org/schemas/sitemap/0.9}'
+
+
+class ChangeCheck:
+    """정보원 1건의 사전 판정 결과"""
+
+    def __init__(self, skip: bool, headers: Dict[str, str], lastmod: Optional[str], stored: Validators):
+        self.skip = skip
+        self.headers = headers
+        self.lastmod = lastmod
+        self.stored = stored
+
+
+class ChangeDetector:
+    """저렴한 색인 문서(sitemap.xml)와 HTTP 검증자로 본문 재취득이 필요한 정보원만 선별"""
+
+    def __init__(self, fetcher: Fetcher, snapshots: SnapshotStore):
+        self.fetcher = fetcher
+        self.snapshots = snapshots
+        self.sitemap_enabled = os.getenv('SITEMAP_DISCOVERY', 'true').lower() == 'true'
+        self.missing_ttl = int(os.getenv('SITEMAP_MISSING_TTL', '86400'))
+        self.max_child_sitemaps = int(os.getenv('SITEMAP_MAX_CHILDREN', '20'))
+        self._missing: Dict[str, float] = {}  # sitemap URL → 재시도 시각 (없는 사이트에 매 실행 요청하지 않음)
+        self.begin_run()
+
+    def begin_run(self):
+        self.full_fetches = 0
+        self.skipped = 0
+        self.not_modified = 0
+
+    def sitemap_url_for(self, url: str, explicit: str = None) -> str:
+        if explicit:
+            return explicit
+        parsed = urlparse(url)
+        return f"{parsed.scheme}://{parsed.netloc}/sitemap.xml"
+
+    def check(self, url: str, config_fingerprint: str, sitemap_url: str = None) -> ChangeCheck:
+        """본문 취득 전 판정 (설정이 바뀐 정보원은 항상 전체 취득)"""
+        stored = self.snapshots.validators(url)
+        if stored.config_fingerprint != config_fingerprint:
+            self.full_fetches += 1
+            return ChangeCheck(False, {}, self.lastmod(url, sitemap_url), stored)
+
+        lastmod = self.lastmod(url, sitemap_url)
+        if lastmod and stored.lastmod == lastmod:
+            self.skipped += 1
+            return ChangeCheck(True, {}, lastmod, stored)
+
+        headers = {}
+        if stored.etag:
+            headers['If-None-Match'] = stored.etag
+        if stored.last_modified:
+            headers['If-Modified-Since'] = stored.last_modified
+        self.full_fetches += 1
+        return ChangeCheck(False, headers, lastmod, stored)
+
+    def mark_not_modified(self, url: str, check: ChangeCheck):
+        """304 응답: 항목 스냅샷은 그대로 두고 lastmod만 갱신"""
+        self.full_fetches -= 1
+        self.not_modified += 1
+        self.snapshots.keep(url, Validators(check.stored.config_fingerprint, check.stored.etag,
+                                            check.stored.last_modified, check.lastmod))
+
+    def lastmod(self, url: str, sitemap_url: str = None) -> Optional[str]:
+        if not self.sitemap_enabled:
+            return None
+        entries = self.sitemap(self.sitemap_url_for(url, sitemap_url))
+        return entries.get(url) or entries.get(url.rstrip('/')) or entries.get(url.rstrip('/') + '/')
+
+    def sitemap(self, sitemap_url: str) -> Dict[str, str]:
+        """loc → lastmod (실행당 1회 취득, 사이트 간 공유)"""
+        retry_at = self._missing.get(sitemap_url)
+        if retry_at and retry_at > clock.time():
+            return {}
+        return self.fetcher.flight.do(('sitemap', sitemap_url), lambda: self._load_sitemap(sitemap_url))
+
+    def _load_sitemap(self, sitemap_url: str) -> Dict[str, str]:
+        entries = {}
+        pending = [sitemap_url]
+        fetched = 0
+        while pending and fetched <= self.max_child_sitemaps:
+            current = pending.pop(0)
+            fetched += 1
+            try:
+                root = ET.fromstring(self.fetcher.get(current).content)
+            except Exception as e:
+                if current == sitemap_url:
+                    logger.info(f"sitemapなし ({sitemap_url}): {str(e)}")
+                    self._missing[sitemap_url] = clock.time() + self.missing_ttl
+                    return {}
+                logger.warning(f"子sitemap取得エラー ({current}): {str(e)}")
+                continue
+
+            if root.tag == f"{SITEMAP_NS}sitemapindex":
+                for child in root.iter(f"{SITEMAP_NS}loc"):
+                    if child.text:
+                        pending.append(urljoin(current, child.text.strip()))
+                continue
+
+            for node in root.iter(f"{SITEMAP_NS}url"):
+                loc = node.findtext(f"{SITEMAP_NS}loc")
+                lastmod = node.findtext(f"{SITEMAP_NS}lastmod")
+                if loc and lastmod:
+                    entries[loc.strip()] = lastmod.strip()
+
+        logger.info(f"sitemap読込 ({sitemap_url}): {len(entries)}件")
+        return entries
+
+    def log_stats(self):
+        logger.info(f"変更検知: 本文取得 {self.full_fetches}件, lastmod一致でスキップ {self.skipped}件, "
+                    f"304応答 {self.not_modified}件")
@@ -43,6 +43,18 @@ echo -n "🔑 Gmail 앱 패스워드 (16자리, 입력 시 보이지 않음): "
 read -s PASSWORD
 echo ""
 
+# 설정 디렉터리 준비 (./config 는 읽기 전용으로 마운트되며, 없으면 빈 디렉터리가 마운트되어 기동에 실패)
+if [ ! -f config/regional_transport_bureaus.json ]; then
+    echo "📁 설정 디렉터리(./config)를 이미지 기본값으로 생성하는 중..."
+    mkdir -p config
+    IMAGE=$(docker-compose -f docker-compose.production.yml config | awk '/image:/ {print $2; exit}')
+    docker pull "$IMAGE" > /dev/null
+    CONTAINER=$(docker create "$IMAGE")
+    docker cp "$CONTAINER:/app/config/." config/
+    docker rm "$CONTAINER" > /dev/null
+    echo "✅ 설정 디렉터리(./config) 생성 완료"
+fi
+
 # .envファイル生成
 cat > .env << EOF
 # 海技士セミナー情報システム 環境設定
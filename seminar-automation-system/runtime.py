@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 프로세스 공통 실행 컨텍스트
+Author: Manus AI
+Date: 2025-09-26
+
+설정(환경 변수)과 프로세스 공통 자원을 한 곳에서 1회만 초기화하고 각 구성 요소에 넘긴다.
+- Settings (settings.py): DB 경로・설정 디렉터리 등
+- Runtime: HTTP 취득 계층, SMTP 연결 풀・Slack 세션・Webhook 연결 풀, 관련도 모델, 작업 실행기, 메모리 예산, 공통 지표
+  (멀티 테넌트에서는 모든 테넌트가 같은 Runtime 을 공유)
+
+DB 연결은 스레드 간에 공유할 수 없으므로 풀링하지 않고, connect() 로 같은 설정(대기 시간)의 연결을 연다.
+"""
+
+import os
+import sqlite3
+import logging
+import threading
+from typing import Dict, List, Optional, Tuple
+
+from fetcher import Fetcher
+from job_executor import JobExecutor
+from memory_monitor import ProcessMemory
+from relevance_model import SeminarClassifier
+from senders import SmtpPool, SlackSender
+from settings import Settings
+from webhooks import WebhookSender
+
+logger = logging.getLogger(__name__)
+
+SENDER_METRICS = (
+    ('seminar_slack_api_calls_total', 'Slack API and webhook calls', lambda runtime: runtime.slack.api_calls),
+    ('seminar_webhook_requests_total', 'Outbound webhook requests including retries', lambda runtime: runtime.webhook.requests_sent),
+    ('seminar_webhook_retries_total', 'Outbound webhook retries', lambda runtime: runtime.webhook.retried),
+)
+
+
+class Runtime:
+    """프로세스에 1개인 실행 컨텍스트 (current() 로 취득, 처음 호출 시 생성)"""
+
+    _current: Optional['Runtime'] = None
+    _current_lock = threading.Lock()
+
+    def __init__(self, settings: Optional[Settings] = None):
+        self.settings = settings or Settings.from_env()
+        self.memory = ProcessMemory()  # RSS・tracemalloc 은 프로세스 전역이므로 테넌트 간 1개
+        self.fetcher = Fetcher(memory=self.memory)
+        self.smtp = SmtpPool()
+        self.slack = SlackSender()
+        self.webhook = WebhookSender()
+        self.executor = JobExecutor()
+        self._classifiers: Dict[Tuple[str, str, float, float], SeminarClassifier] = {}
+        self._classifiers_lock = threading.Lock()
+        logger.info(f"実行コンテキスト初期化: DB {self.settings.db_path}, 設定 {self.settings.config_dir}")
+
+    @classmethod
+    def current(cls) -> 'Runtime':
+        with cls._current_lock:
+            if cls._current is None:
+                cls._current = cls()
+            return cls._current
+
+    @classmethod
+    def install(cls, runtime: 'Runtime') -> 'Runtime':
+        """프로세스 컨텍스트 교체 (시작 시 설정을 직접 지정하는 경우)"""
+        with cls._current_lock:
+            cls._current = runtime
+        return runtime
+
+    def connect(self, db_path: Optional[str] = None) -> sqlite3.Connection:
+        """DB 연결 (생략 시 설정의 DB, 다른 스레드・프로세스의 쓰기 잠금은 DB_TIMEOUT 초까지 대기)"""
+        return sqlite3.connect(db_path or self.settings.db_path, timeout=self.settings.db_timeout)
+
+    def classifier(self, config_dir: str, db_path: str, tenant: Optional[str] = None) -> SeminarClassifier:
+        """설정 디렉터리・모델 파일・판정 임계값 단위로 1개만 로드
+
+        테넌트는 DB 옆의 자체 모델 파일(<DB 경로>.relevance_model.npz)을 쓴다 (다른 테넌트의 데이터로 학습된 모델 공유 방지).
+        """
+        model_path = f"{os.path.splitext(db_path)[0]}.relevance_model.npz" if tenant else None
+        classifier = SeminarClassifier(model_path)
+        key = (config_dir, classifier.model_path, classifier.threshold, classifier.status_threshold)
+        with self._classifiers_lock:
+            if key not in self._classifiers:
+                classifier.load()
+                self._classifiers[key] = classifier
+            return self._classifiers[key]
+
+    def metrics(self) -> List[str]:
+        """공통 자원의 Prometheus 지표 (호스트별 취득 + 발송 호출 수)"""
+        lines = self.fetcher.metrics()
+        for name, description, value in SENDER_METRICS:
+            lines.append(f'# HELP {name} {description}')
+            lines.append(f'# TYPE {name} counter')
+            lines.append(f'{name} {value(self):g}')
+        return lines
+
+    def close(self):
+        self.executor.shutdown(cancel=True)
+        self.smtp.close()
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 상시 샘플링 프로파일러
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import sys
+import time
+import logging
+import threading
+from collections import Counter, deque
+from typing import Dict
+
+logger = logging.getLogger(__name__)
+
+
+class SamplingProfiler:
+    """일정 간격으로 전 스레드의 스택을 샘플링해 초 단위로 집계"""
+
+    def __init__(self, interval: float = None, window_seconds: int = None, max_depth: int = 64):
+        self.interval = interval or float(os.getenv('PROFILER_INTERVAL', '0.02'))
+        self.window_seconds = window_seconds or int(os.getenv('PROFILER_WINDOW_SECONDS', '600'))
+        self.max_depth = max_depth
+        self._buckets = deque()  # (epoch second, Counter)
+        self._lock = threading.Lock()
+        self._stop = threading.Event()
+        self._thread = None
+        self._labels = {}
+
+    def start(self):
+        if self._thread and self._thread.is_alive():
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name='sampling-profiler', daemon=True)
+        self._thread.start()
+        logger.info(f"サンプリングプロファイラー開始: 間隔 {self.interval * 1000:.0f}ms, 保持 {self.window_seconds}秒")
+
+    def stop(self):
+        self._stop.set()
+        if self._thread:
+            self._thread.join(timeout=1.0)
+
+    def _run(self):
+        own_id = threading.get_ident()
+        while not self._stop.wait(self.interval):
+            names = {t.ident: t.name for t in threading.enumerate()}
+            now = int(time.time())
+            samples = Counter()
+            for thread_id, frame in sys._current_frames().items():
+                if thread_id == own_id:
+                    continue
+                samples[self._collapse(names.get(thread_id, str(thread_id)), frame)] += 1
+            self._record(now, samples)
+
+    def _collapse(self, thread_name: str, frame) -> str:
+        """루트부터 리프 순의 collapsed 스택 문자열"""
+        parts = []
+        depth = 0
+        while frame is not None and depth < self.max_depth:
+            parts.append(self._label(frame.f_code))
+            frame = frame.f_back
+            depth += 1
+        parts.append(thread_name)
+        return ';'.join(reversed(parts))
+
+    def _label(self, code) -> str:
+        label = self._labels.get(code)
+        if label is None:
+            label = f"{code.co_name} ({os.path.basename(code.co_filename)}:{code.co_firstlineno})"
+            self._labels[code] = label
+        return label
+
+    def _record(self, second: int, samples: Counter):
+        with self._lock:
+            if self._buckets and self._buckets[-1][0] == second:
+                self._buckets[-1][1].update(samples)
+            else:
+                self._buckets.append((second, samples))
+            cutoff = second - self.window_seconds
+            while self._buckets and self._buckets[0][0] <= cutoff:
+                self._buckets.popleft()
+
+    def collect(self, seconds: int) -> Counter:
+        """최근 N초간의 스택 샘플 합계"""
+        cutoff = int(time.time()) - seconds
+        total = Counter()
+        with self._lock:
+            for second, samples in reversed(self._buckets):
+                if second <= cutoff:
+                    break
+                total.update(samples)
+        return total
+
+    def collapsed(self, seconds: int) -> str:
+        """flamegraph.pl / speedscope 호환 collapsed 형식"""
+        return ''.join(f"{stack} {count}\n" for stack, count in self.collect(seconds).most_common())
+
+    def summary(self, seconds: int) -> Dict:
+        stacks = self.collect(seconds)
+        return {
+            'seconds': seconds,
+            'interval': self.interval,
+            'samples': sum(stacks.values()),
+            'stacks': dict(stacks.most_common())
+        }
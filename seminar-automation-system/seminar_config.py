@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 설정 로드 및 변경 감시
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import re
+import json
+import struct
+import threading
+import hashlib
+import logging
+import ctypes
+import ctypes.util
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from gazetteer import Gazetteer
+
+logger = logging.getLogger(__name__)
+
+BUREAUS_FILE = 'regional_transport_bureaus.json'
+KEYWORDS_FILE = 'seminar_keywords.json'
+GAZETTEER_FILE = 'gazetteer.json'
+
+# 지방운수국명 → DB 지역명
+REGION_MAPPING = {
+    '北海道運輸局': '북해도',
+    '東北運輸局': '동북',
+    '関東運輸局': '관동',
+    '北陸信越運輸局': '북륙신월',
+    '中部運輸局': '중부',
+    '近畿運輸局': '근기',
+    '神戸運輸監理部': '고베',
+    '中国運輸局': '중국',
+    '四国運輸局': '사국',
+    '九州運輸局': '구주'
+}
+
+# seminars.status CHECK 제약과 동일
+VALID_STATUSES = {'募集中', '募集予定', '募集締切', '募集期限切れ', '開催予定', '開催終了', '中止', 'その他'}
+
+
+class SeminarConfig:
+    """컴파일된 설정 스냅샷 (교체 단위, 생성 후 변경하지 않음)"""
+
+    def __init__(self, bureaus_data: List[Dict], keywords_data: Dict, fingerprint: str,
+                 gazetteer_data: Optional[List[Dict]] = None):
+        self.fingerprint = fingerprint
+
+        self.seminar_keywords = list(keywords_data['seminar_keywords'])
+        self.status_keywords = dict(keywords_data['status_keywords'])
+        if not self.seminar_keywords:
+            raise ValueError("seminar_keywords が空です")
+        invalid = set(self.status_keywords.values()) - VALID_STATUSES
+        if invalid:
+            raise ValueError(f"不正なステータス: {', '.join(sorted(invalid))}")
+
+        # 키워드 매처 컴파일 (대소문자 무시)
+        self.seminar_pattern = re.compile(
+            '|'.join(re.escape(keyword) for keyword in self.seminar_keywords), re.IGNORECASE)
+        # 상태 판정은 정의 순서 우선이므로 순서를 유지한 목록으로 보관
+        self.status_rules = tuple(self.status_keywords.items())
+
+        self.transport_bureaus = {}
+        for bureau in bureaus_data:
+            if bureau['name'] in REGION_MAPPING:
+                region_name = REGION_MAPPING[bureau['name']]
+                area_keywords = bureau.get('area_keywords', [])
+                self.transport_bureaus[region_name] = {
+                    'name': bureau['name'],
+                    'url': bureau['url'],
+                    'seminar_url': bureau.get('seminar_url'),
+                    'sitemap_url': bureau.get('sitemap_url'),  # 생략 시 호스트의 /sitemap.xml
+                    'type': 'html',  # 기본값, RSS 확인 후 변경 가능
+                    'area_pattern': re.compile('|'.join(re.escape(k) for k in area_keywords), re.IGNORECASE)
+                                    if area_keywords else None
+                }
+
+        # 정보원 레지스트리: URL → 해당 URL을 사용하는 지역 목록 (URL당 1회 취득)
+        self.sources = {}
+        for region_name, bureau_info in self.transport_bureaus.items():
+            for url in (bureau_info['url'], bureau_info['seminar_url']):
+                if not url:
+                    continue
+                source = self.sources.setdefault(url, {'url': url, 'type': bureau_info['type'],
+                                                       'sitemap_url': bureau_info['sitemap_url'], 'regions': []})
+                if region_name not in source['regions']:
+                    source['regions'].append(region_name)
+
+        # 개최지 지오코딩용 지명 사전 (트라이로 컴파일)
+        self.gazetteer = Gazetteer(gazetteer_data or [])
+
+    @classmethod
+    def load(cls, config_dir: str, reload: bool = False) -> 'SeminarConfig':
+        """설정 디렉토리에서 로드 (검증 실패 시 예외, reload=True면 지방운수국 파일 누락도 예외)"""
+        config_path = Path(config_dir)
+        digest = hashlib.sha256()
+
+        try:
+            with open(config_path / BUREAUS_FILE, 'rb') as f:
+                raw = f.read()
+            digest.update(raw)
+            bureaus_data = json.loads(raw.decode('utf-8'))
+        except FileNotFoundError:
+            if reload:
+                # 실행 중 빈 목록으로 교체되면 모든 정보원 감시가 조용히 멈추므로 현행 설정을 유지시킨다
+                raise
+            logger.error("地方運輸局情報ファイルが見つかりません")
+            bureaus_data = []
+
+        with open(config_path / KEYWORDS_FILE, 'rb') as f:
+            raw = f.read()
+        digest.update(raw)
+        keywords_data = json.loads(raw.decode('utf-8'))
+
+        try:
+            with open(config_path / GAZETTEER_FILE, 'rb') as f:
+                raw = f.read()
+            digest.update(raw)
+            gazetteer_data = json.loads(raw.decode('utf-8'))
+        except FileNotFoundError:
+            logger.warning("地名辞書ファイルが見つかりません (開催地の位置特定は無効)")
+            gazetteer_data = []
+
+        return cls(bureaus_data, keywords_data, digest.hexdigest(), gazetteer_data)
+
+
+class ConfigWatcher:
+    """설정 디렉토리 변경 감시 (Linux inotify, 불가 시 mtime 폴링)"""
+
+    IN_MODIFY = 0x00000002
+    IN_CLOSE_WRITE = 0x00000008
+    IN_MOVED_TO = 0x00000080
+    IN_CREATE = 0x00000100
+    IN_DELETE = 0x00000200
+    EVENT_HEADER = struct.Struct('iIII')
+
+    def __init__(self, config_dir: str):
+        self.config_dir = config_dir
+        self._fd = None
+        self._lock = threading.Lock()
+        self._last_stat = self._stat_signature()
+        self._init_inotify()
+
+    def _init_inotify(self):
+        try:
+            libc = ctypes.CDLL(ctypes.util.find_library('c') or 'libc.so.6', use_errno=True)
+            fd = libc.inotify_init1(os.O_NONBLOCK | os.O_CLOEXEC)
+            if fd < 0:
+                raise OSError(ctypes.get_errno(), 'inotify_init1')
+            mask = self.IN_MODIFY | self.IN_CLOSE_WRITE | self.IN_MOVED_TO | self.IN_CREATE | self.IN_DELETE
+            if libc.inotify_add_watch(fd, os.fsencode(self.config_dir), mask) < 0:
+                os.close(fd)
+                raise OSError(ctypes.get_errno(), 'inotify_add_watch')
+            self._fd = fd
+            logger.info(f"設定ディレクトリ監視開始 (inotify): {self.config_dir}")
+        except (OSError, AttributeError) as e:
+            logger.info(f"inotifyが利用できないためポーリングで監視します: {str(e)}")
+
+    def changed(self) -> bool:
+        """마지막 확인 이후 변경 여부 (논블로킹, 스레드 안전)"""
+        with self._lock:
+            return self._poll()
+
+    def _poll(self) -> bool:
+        changed = False
+        if self._fd is not None:
+            while True:
+                try:
+                    data = os.read(self._fd, 4096)
+                except BlockingIOError:
+                    break
+                if not data:
+                    break
+                changed = changed or len(data) >= self.EVENT_HEADER.size
+
+        # 호스트 측 변경이 inotify로 전달되지 않는 마운트도 있으므로 mtime도 비교
+        signature = self._stat_signature()
+        if signature != self._last_stat:
+            self._last_stat = signature
+            changed = True
+        return changed
+
+    def _stat_signature(self) -> Optional[tuple]:
+        try:
+            return tuple(
+                (entry.name, entry.stat().st_mtime_ns, entry.stat().st_size)
+                for entry in sorted(os.scandir(self.config_dir), key=lambda e: e.name)
+            )
+        except OSError:
+            return None
+
+    def close(self):
+        with self._lock:
+            if self._fd is not None:
+                os.close(self._fd)
+                self._fd = None
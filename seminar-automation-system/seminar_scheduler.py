@@ -11,9 +11,16 @@ import time
 import logging
 import sys
 import os
-from datetime import datetime
+from functools import partial
 import pytz
 from seminar_automation_system import SeminarAutomationSystem
+from admin_server import AdminServer
+from sampling_profiler import SamplingProfiler
+from job_executor import JobExecutor, JobSpec
+from shadow import ShadowRunner
+from runtime import Runtime
+import extraction
+import clock
 
 # 로그 설정
 logging.basicConfig(
@@ -30,88 +37,126 @@ logger = logging.getLogger(__name__)
 JST = pytz.timezone('Asia/Tokyo')
 
 class SeminarScheduler:
-    def __init__(self):
-        self.system = SeminarAutomationSystem()
+    def __init__(self, system: SeminarAutomationSystem = None, executor: JobExecutor = None, tenant: str = None):
+        """executor 생략 시 실행 컨텍스트의 작업 실행기 (멀티 테넌트에서는 테넌트 간 공유, tenants.TenantHost)"""
+        self.system = system or SeminarAutomationSystem()
         self.retry_count = 0
         self.max_retries = 1
         self.last_execution_status = None
+        self.admin_server = None
+        self.profiler = None
+        self.executor = executor
+        self.tenant = tenant
+        self.label = f"[{tenant}] " if tenant else ''
+        self.retry_tag = f'retry:{tenant}' if tenant else 'retry'
+
+        # 섀도 모드: 같은 취득 결과로 대체 설정의 파이프라인을 Dry-run 하여 비교 (SHADOW_MODE)
+        self.shadow = ShadowRunner.from_env(self.system)
+
+    def job_name(self, name: str) -> str:
+        return f'{self.tenant}/{name}' if self.tenant else name
         
     def run_main_process(self, dry_run: bool = True):
         """메인 프로세스 실행"""
         try:
-            current_time = datetime.now(JST)
-            logger.info(f"海技士セミナー自動化システム実行開始: {current_time.strftime('%Y-%m-%d %H:%M:%S')}")
+            current_time = clock.now(JST)
+            logger.info(f"{self.label}海技士セミナー自動化システム実行開始: {current_time.strftime('%Y-%m-%d %H:%M:%S')}")
             
+            # 설정 변경이 있으면 실행 전에 교체
+            self.system.reload_config_if_changed()
+
             # 메인 프로세스 실행
-            self.system.main_process(dry_run=dry_run)
+            self.run_with_shadow(dry_run)
             
             self.last_execution_status = 'success'
             self.retry_count = 0
             
-            logger.info("海技士セミナー自動化システム実行完了")
+            logger.info(f"{self.label}海技士セミナー自動化システム実行完了")
             
         except Exception as e:
             self.last_execution_status = 'failed'
-            logger.error(f"海技士セミナー自動化システム実行失敗: {str(e)}")
+            logger.error(f"{self.label}海技士セミナー自動化システム実行失敗: {str(e)}")
             
-            # 재시도 로직
-            if self.retry_count < self.max_retries:
+            # 재시도 로직 (1회 실행(run_once)은 스케줄 루프・작업 실행기가 없으므로 재시도 없이 바로 알림)
+            if self.executor is None:
+                logger.critical("即時実行のため再実行なし。運用担当者に通知します。")
+                self.notify_ops_failure(str(e), dry_run)
+            elif self.retry_count < self.max_retries:
                 self.retry_count += 1
                 logger.info(f"30分後に再実行予定 ({self.retry_count}/{self.max_retries})")
                 
                 # 30분 후 재시도 스케줄 등록
-                schedule.every(30).minutes.do(self.retry_main_process, dry_run=dry_run).tag('retry')
+                schedule.every(30).minutes.do(self.executor.submit, self.job_name('retry')).tag(self.retry_tag)
             else:
                 logger.critical("최대 재시도 횟수 초과. 운영 담당자에게 알림이 필요합니다.")
-                self.notify_ops_failure(str(e))
+                self.notify_ops_failure(str(e), dry_run)
     
+    def run_with_shadow(self, dry_run: bool):
+        """메인 프로세스 실행 (섀도 모드면 성공한 실행 직후 대체 파이프라인과 비교, 비교 실패는 운영에 영향 없음)"""
+        if self.shadow is None:
+            self.system.main_process(dry_run=dry_run)
+            return
+
+        try:
+            self.shadow.prepare()
+        except Exception as e:
+            logger.error(f"{self.label}シャドー準備エラー (比較なしで実行): {str(e)}")
+            self.system.main_process(dry_run=dry_run)
+            return
+
+        try:
+            self.system.main_process(dry_run=dry_run)
+        except Exception:
+            self.shadow.release()
+            raise
+        try:
+            self.shadow.run()
+        except Exception as e:
+            logger.error(f"{self.label}シャドー比較エラー: {str(e)}")
+
     def retry_main_process(self, dry_run: bool = True):
         """재시도 프로세스 실행"""
-        logger.info(f"海技士セミナー自動化システム再実行 ({self.retry_count}/{self.max_retries})")
+        logger.info(f"{self.label}海技士セミナー自動化システム再実行 ({self.retry_count}/{self.max_retries})")
         
         try:
             self.system.main_process(dry_run=dry_run)
             
             self.last_execution_status = 'success_retry'
-            logger.info("海技士セミナー自動化システム再実行成功")
+            logger.info(f"{self.label}海技士セミナー自動化システム再実行成功")
             
             # 재시도 스케줄 제거
-            schedule.clear('retry')
+            schedule.clear(self.retry_tag)
             
         except Exception as e:
-            logger.error(f"海技士セミナー自動化システム再実行失敗: {str(e)}")
+            logger.error(f"{self.label}海技士セミナー自動化システム再実行失敗: {str(e)}")
             
             if self.retry_count >= self.max_retries:
                 logger.critical("재시도 실패. 운영 담당자에게 알림이 필요합니다.")
-                self.notify_ops_failure(str(e))
+                self.notify_ops_failure(str(e), dry_run)
                 
                 # 재시도 스케줄 제거
-                schedule.clear('retry')
+                schedule.clear(self.retry_tag)
     
-    def notify_ops_failure(self, error_message: str):
-        """운영 담당자에게 장애 알림"""
-        failure_time = datetime.now(JST).strftime('%Y-%m-%d %H:%M:%S')
-        
-        # 실제 구현에서는 이메일이나 Slack으로 알림 발송
-        logger.critical(f"""
-=== 해기사 세미나 자동화 시스템 장애 알림 ===
-발생 시각: {failure_time}
-오류 내용: {error_message}
-재시도 횟수: {self.retry_count}/{self.max_retries}
-
-시스템의 수동 확인과 복구 작업이 필요합니다.
-로그 파일: /home/ubuntu/seminar_scheduler.log
-        """)
+    def notify_ops_failure(self, error_message: str, dry_run: bool = True):
+        """운영 담당자에게 장애 알림 (OPS_EMAIL・OPS_SLACK, 같은 장애는 쿨다운 동안 1회)"""
+        failure_time = clock.now(JST).strftime('%Y-%m-%d %H:%M:%S')
+        message = (f"発生時刻: {failure_time}\n"
+                   f"エラー内容: {error_message}\n"
+                   f"再試行回数: {self.retry_count}/{self.max_retries}\n\n"
+                   f"システムの手動確認と復旧作業が必要です。\n"
+                   f"ログファイル: /app/logs/seminar_scheduler.log")
+
+        self.system.alerts.raise_alert('main_process_failed', f"【運用アラート】{self.label}海技士セミナー自動化システム障害", message)
+        self.system.alerts.flush(dry_run)
     
     def health_check(self):
         """시스템 상태 확인"""
-        current_time = datetime.now(JST)
+        current_time = clock.now(JST)
         logger.info(f"海技士セミナー自動化システム状態確認: {current_time.strftime('%Y-%m-%d %H:%M:%S')}")
         
         # 데이터베이스 연결 확인
         try:
-            import sqlite3
-            conn = sqlite3.connect('/home/ubuntu/seminar_automation.db')
+            conn = self.system.runtime.connect(self.system.db_path)
             cursor = conn.cursor()
             cursor.execute('SELECT COUNT(*) FROM seminars')
             seminar_count = cursor.fetchone()[0]
@@ -122,27 +167,82 @@ class SeminarScheduler:
         except Exception as e:
             logger.error(f"データベース接続エラー: {str(e)}")
     
-    def setup_schedule(self, dry_run: bool = True):
-        """스케줄 설정"""
-        # 매일 오전 9시에 실행
-        schedule.every().day.at("09:00").do(self.run_main_process, dry_run=dry_run).tag('main')
+    def start_admin_server(self):
+        """관리 서버 및 상시 샘플링 프로파일러 시작"""
+        self.admin_server = AdminServer()
+
+        if os.getenv('PROFILER_ENABLED', 'true').lower() in ('true', '1', 'yes'):
+            self.profiler = SamplingProfiler()
+            self.profiler.start()
+            self.admin_server.add_route('/debug/profile', self.profile_endpoint, protected=True)
+
+        # 구독자별 캘린더 피드 (/calendar/<token>.ics, ETag・If-None-Match 대응, 조각은 기동 시 1회 보완)
+        self.system.calendar.refresh_fragments()
+        self.admin_server.add_route('/calendar/', self.system.calendar.endpoint, prefix=True)
+
+        # 호스트별 동시 요청 상한 등 (Prometheus 텍스트 형식)
+        self.admin_server.add_route('/metrics', self.metrics_endpoint, protected=True)
+
+        try:
+            self.admin_server.start()
+        except OSError as e:
+            logger.error(f"管理サーバー開始エラー: {str(e)}")
+
+    def metrics_endpoint(self, query: dict, headers: dict):
+        """/metrics - 수집 계층・알림 지표"""
+        lines = self.system.runtime.metrics() + self.system.alerts.metrics()
+        return 200, 'text/plain; version=0.0.4', '\n'.join(lines) + '\n'
+
+    def profile_endpoint(self, query: dict, headers: dict):
+        """/debug/profile?seconds=N - 최근 N초간의 collapsed 스택 (format=json 지원)"""
+        try:
+            seconds = int(query.get('seconds', '30'))
+        except ValueError:
+            return 400, 'application/json', {'error': 'seconds must be an integer'}
+        seconds = max(1, min(seconds, self.profiler.window_seconds))
+
+        if query.get('format') == 'json':
+            return 200, 'application/json', self.profiler.summary(seconds)
+        return 200, 'text/plain', self.profiler.collapsed(seconds)
+
+    def setup_executor(self, dry_run: bool = True):
+        """작업 실행기 설정 (메인 프로세스와 재시도는 같은 그룹에서 1건씩, 실행 중이면 건너뜀)"""
+        if self.executor is None:
+            self.executor = self.system.runtime.executor
+        self.executor.register(JobSpec('main', partial(self.run_main_process, dry_run=dry_run),
+                                       lane='long', group='main', overlap='skip', tenant=self.tenant))
+        self.executor.register(JobSpec('retry', partial(self.retry_main_process, dry_run=dry_run),
+                                       lane='long', group='main', overlap='skip', tenant=self.tenant))
+        self.executor.register(JobSpec('health', self.health_check, lane='short', overlap='skip', tenant=self.tenant))
+
+    def setup_schedule(self, dry_run: bool = True, main_at: str = "09:00"):
+        """스케줄 설정 (schedule 은 작업 투입만 하고 실행은 작업 실행기에서)"""
+        self.setup_executor(dry_run=dry_run)
+
+        # 매일 오전 9시에 실행 (테넌트별로 변경 가능)
+        schedule.every().day.at(main_at).do(self.executor.submit, self.job_name('main')).tag('main', self.tenant or 'main')
         
         # 매시간 상태 확인 (선택사항)
-        schedule.every().hour.do(self.health_check).tag('health')
+        schedule.every().hour.do(self.executor.submit, self.job_name('health')).tag('health', self.tenant or 'health')
         
-        logger.info("スケジュール設定完了:")
-        logger.info("  - 毎日09:00 JST: メインプロセス実行")
+        logger.info(f"{self.label}スケジュール設定完了:")
+        logger.info(f"  - 毎日{main_at} JST: メインプロセス実行")
         logger.info("  - 毎時: 状態確認")
         logger.info(f"  - Dry-runモード: {'有効' if dry_run else '無効'}")
+        logger.info(f"  - 抽出モジュール: {'コンパイル版 (mypyc)' if extraction.COMPILED else '純Python版'}")
+        logger.info("  - ジョブ重複時: " + ', '.join(f"{spec.name}={spec.overlap}" for spec in self.executor.specs.values()
+                                                   if spec.tenant == self.tenant))
     
     def run_scheduler(self, dry_run: bool = True):
         """스케줄러 실행"""
         self.setup_schedule(dry_run=dry_run)
+        self.start_admin_server()
         
         logger.info("海技士セミナー自動化システムスケジューラー開始")
         
         try:
             while True:
+                # 설정 재로드는 run_main_process 시작 시에만 (실행 중 교체 방지)
                 schedule.run_pending()
                 time.sleep(60)  # 1분마다 스케줄 확인
                 
@@ -150,15 +250,32 @@ class SeminarScheduler:
             logger.info("スケジューラーがユーザーによって停止されました")
         except Exception as e:
             logger.error(f"スケジューラー実行中エラー: {str(e)}")
+        finally:
+            self.executor.shutdown(cancel=True)
     
     def run_once(self, dry_run: bool = True):
         """즉시 1회 실행 (테스트용)"""
         logger.info("海技士セミナー自動化システム即座実行")
         self.run_main_process(dry_run=dry_run)
 
+def run_tenants(tenants_file: str, dry_run: bool):
+    """멀티 테넌트 모드 (하나의 프로세스에서 여러 설정을 실행)"""
+    from tenants import TenantHost
+    TenantHost(tenants_file).run(dry_run=dry_run)
+
 def main():
     """메인 함수"""
-    scheduler = SeminarScheduler()
+    # 설정・공통 자원은 여기서 1회만 초기화하고 이후 구성 요소는 모두 같은 컨텍스트를 사용
+    runtime = Runtime.current()
+    dry_run_env = runtime.settings.dry_run
+    if len(sys.argv) > 2 and sys.argv[1] == '--tenants':
+        run_tenants(sys.argv[2], dry_run_env)
+        return
+    if len(sys.argv) == 1 and runtime.settings.tenants_file:
+        run_tenants(runtime.settings.tenants_file, dry_run_env)
+        return
+
+    scheduler = SeminarScheduler(system=SeminarAutomationSystem(runtime=runtime))
     
     # 명령행 인수 처리
     if len(sys.argv) > 1:
@@ -177,6 +294,9 @@ def main():
         elif sys.argv[1] == '--health':
             # 상태 확인
             scheduler.health_check()
+        elif sys.argv[1] == '--calendar-url' and len(sys.argv) > 2:
+            # 구독자 캘린더 피드 경로 발급
+            print(f"/calendar/{scheduler.system.calendar.token_for(int(sys.argv[2]))}.ics")
         else:
             print("사용법:")
             print("  python seminar_scheduler.py --test              # 즉시 1회 실행 (Dry-run)")
@@ -184,9 +304,10 @@ def main():
             print("  python seminar_scheduler.py --schedule          # 스케줄러 실행 (Dry-run)")
             print("  python seminar_scheduler.py --schedule-production # 스케줄러 실행 (실제 발송)")
             print("  python seminar_scheduler.py --health            # 상태 확인")
+            print("  python seminar_scheduler.py --calendar-url ID   # 구독자 캘린더 피드 경로")
+            print("  python seminar_scheduler.py --tenants FILE      # 멀티 테넌트 스케줄러 (DRY_RUN 환경변수)")
     else:
         # 환경변수에서 DRY_RUN 설정 읽기 (기본값: True)
-        dry_run_env = os.getenv('DRY_RUN', 'true').lower() in ('true', '1', 'yes')
         scheduler.run_scheduler(dry_run=dry_run_env)
 
 if __name__ == "__main__":
@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 프로세스 설정
+Author: Manus AI
+Date: 2025-09-26
+
+경로・실행 모드 등 프로세스 단위 설정을 환경 변수에서 읽는 곳 (헬스체크에서도 쓰므로 표준 라이브러리만 사용).
+    DB_PATH, CONFIG_DIR, TENANTS_FILE, TENANT_DATA_DIR, DB_TIMEOUT, DRY_RUN
+구성 요소별 조정값(SMTP・Slack・Webhook・수집・판정 임계값 등)은 각 모듈이 생성 시 환경 변수에서 읽는다.
+DB 연결은 모두 Runtime.connect 를 거쳐 DB_TIMEOUT 을 적용한다.
+"""
+
+import os
+from dataclasses import dataclass
+from typing import Optional
+
+
+@dataclass(frozen=True)
+class Settings:
+    """프로세스 단위 설정 (이 항목들의 환경 변수는 여기서만 읽음)"""
+    db_path: str = '/app/data/seminar_automation.db'
+    config_dir: str = '/app/config'
+    tenants_file: Optional[str] = None
+    tenant_data_dir: str = '/app/data/tenants'
+    db_timeout: float = 30.0
+    dry_run: bool = True
+
+    @classmethod
+    def from_env(cls) -> 'Settings':
+        return cls(
+            db_path=os.getenv('DB_PATH', cls.db_path),
+            config_dir=os.getenv('CONFIG_DIR', cls.config_dir),
+            tenants_file=os.getenv('TENANTS_FILE') or None,
+            tenant_data_dir=os.getenv('TENANT_DATA_DIR', cls.tenant_data_dir),
+            db_timeout=float(os.getenv('DB_TIMEOUT', str(cls.db_timeout))),
+            dry_run=os.getenv('DRY_RUN', 'true').lower() in ('true', '1', 'yes'),
+        )
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 섀도 모드 (A/B 비교)
+Author: Manus AI
+Date: 2025-09-26
+
+운영 실행(main_process)이 취득한 바이트를 그대로 재생해 대체 설정의 파이프라인을 Dry-run 으로 실행하고,
+저장된 항목・통지・단계별 소요 시간/메모리를 비교한다. 대체 파이프라인은 네트워크에 접근하지 않고
+DB 는 실행 직전 운영 DB 의 복사본을 사용하므로 운영 데이터와 발송에는 영향이 없다.
+
+설정:
+    SHADOW_MODE=true
+    SHADOW_CONFIG_DIR=/app/config-shadow          # 대체 설정 (키워드・정보원), 생략 시 운영과 같음
+    SHADOW_ENV='{"PROCESS_BATCH_SIZE": "10"}'     # 대체 파이프라인에만 적용하는 환경변수
+    SHADOW_REPORT=/app/logs/shadow.jsonl          # 비교 결과 (1실행 1행)
+
+사용 예 (즉시 1회 비교, 운영 측도 Dry-run):
+    python shadow.py
+"""
+
+import os
+import json
+import logging
+import hashlib
+import threading
+from contextlib import contextmanager
+from typing import Dict, Hashable, List, Optional, Tuple
+
+import pytz
+import requests
+
+from fetcher import Fetcher, FetchResult
+from seminar_automation_system import SeminarAutomationSystem
+import clock
+
+logger = logging.getLogger(__name__)
+
+JST = pytz.timezone('Asia/Tokyo')
+
+SAMPLE_LIMIT = 20
+
+_environ_lock = threading.Lock()
+
+
+class ReplayFetcher(Fetcher):
+    """운영 실행의 취득 결과를 재생 (같은 요청 키가 없으면 오류로 취급, 네트워크 접근 없음)"""
+
+    def __init__(self, recorded: Dict[Hashable, Tuple[Optional[FetchResult], Optional[Exception]]]):
+        super().__init__()
+        self.recorded = recorded
+        self.misses: List[str] = []
+
+    def _get(self, url: str, headers: Optional[Dict[str, str]]) -> FetchResult:
+        key = ('GET', url, tuple(sorted(headers.items())) if headers else None)
+        if key not in self.recorded:
+            self.misses.append(url)
+            raise requests.HTTPError(f"shadow replay miss: {url}")
+        result, error = self.recorded[key]
+        with self._sent_lock:
+            self.requests_sent += 1
+        if error is not None:
+            raise error
+        return result
+
+
+class RunCapture:
+    """파이프라인 1회분의 저장 항목・통지를 기록 (원래 메서드에 위임)"""
+
+    def __init__(self, system: SeminarAutomationSystem):
+        self.items: Dict[str, Dict] = {}
+        self.notifications: Dict[Tuple, str] = {}
+        save_seminar, send_notification = system.save_seminar, system.send_notification
+
+        def capture_save(seminar: Dict) -> int:
+            seminar_id = save_seminar(seminar)
+            if seminar_id:
+                self.items[seminar['hash']] = {key: seminar.get(key) for key in
+                                               ('title', 'regions', 'event_date', 'status', 'location')}
+            return seminar_id
+
+        def capture_send(route: Dict, summary: str, seminars: List[Dict], dry_run: bool = True):
+            key = (route['channel'], route['address'],
+                   tuple(sorted(f"{seminar['title']}|{seminar.get('event_date')}" for seminar in seminars)))
+            self.notifications[key] = hashlib.sha256(summary.encode('utf-8')).hexdigest()[:16]
+            return send_notification(route, summary, seminars, dry_run)
+
+        system.save_seminar = capture_save
+        system.send_notification = capture_send
+
+
+@contextmanager
+def overridden_environ(overrides: Dict[str, str]):
+    """대체 파이프라인 생성 중에만 환경변수를 교체 (설정값은 생성 시 읽힘)"""
+    with _environ_lock:
+        saved = {key: os.environ.get(key) for key in overrides}
+        os.environ.update(overrides)
+        try:
+            yield
+        finally:
+            for key, value in saved.items():
+                if value is None:
+                    os.environ.pop(key, None)
+                else:
+                    os.environ[key] = value
+
+
+class ShadowRunner:
+    """운영 실행 전후에 끼워 넣어 대체 파이프라인을 실행・비교"""
+
+    def __init__(self, primary: SeminarAutomationSystem, config_dir: str = None,
+                 overrides: Dict[str, str] = None, work_dir: str = None, report_path: str = None):
+        self.primary = primary
+        self.config_dir = config_dir or os.getenv('SHADOW_CONFIG_DIR') or primary.config_dir
+        self.overrides = {'TRACE_EXPORTER': 'none'}  # 섀도 측 트레이스는 운영 트레이스에 섞지 않음
+        self.overrides.update(overrides if overrides is not None else json.loads(os.getenv('SHADOW_ENV', '{}')))
+        self.work_dir = work_dir or os.path.join(os.getenv('SHADOW_DIR', '/app/data/shadow'), primary.tenant or 'default')
+        self.report_path = report_path or os.getenv('SHADOW_REPORT', '/app/logs/shadow.jsonl')
+        self.shadow_db_path = os.path.join(self.work_dir, 'shadow.db')
+        self.capture: Optional[RunCapture] = None
+
+    @classmethod
+    def from_env(cls, primary: SeminarAutomationSystem) -> Optional['ShadowRunner']:
+        if os.getenv('SHADOW_MODE', 'false').lower() not in ('true', '1', 'yes'):
+            return None
+        return cls(primary)
+
+    def prepare(self):
+        """운영 실행 직전: DB 복사 (중복 판정・스냅샷 상태를 운영과 맞춤) 및 기록 시작"""
+        os.makedirs(self.work_dir, exist_ok=True)
+        source = self.primary.runtime.connect(self.primary.db_path)
+        target = self.primary.runtime.connect(self.shadow_db_path)
+        try:
+            source.backup(target)
+        finally:
+            target.close()
+            source.close()
+        self.capture = RunCapture(self.primary)
+        self.primary.record_fetches = True
+        self.primary.recorded_fetches = None
+
+    def release(self):
+        """운영 측 기록 해제"""
+        for name in ('save_seminar', 'send_notification'):
+            self.primary.__dict__.pop(name, None)
+        self.primary.record_fetches = False
+
+    def run(self) -> Dict:
+        """운영 실행 직후: 같은 취득 결과로 대체 파이프라인을 Dry-run 후 비교 결과를 기록"""
+        primary_capture = self.capture
+        primary_stages = dict(self.primary.memory.stages)
+        self.release()
+
+        # 운영 실행이 end_run 직전에 보관한 결과 (공유 Fetcher 의 현재 내용은 다른 테넌트가 이미 비웠을 수 있음)
+        recorded, self.primary.recorded_fetches = self.primary.recorded_fetches or {}, None
+        replay = ReplayFetcher(recorded)
+        with overridden_environ(self.overrides):
+            shadow = SeminarAutomationSystem(db_path=self.shadow_db_path, config_dir=self.config_dir,
+                                             runtime=self.primary.runtime, tenant=self.primary.tenant)
+        shadow.fetcher = replay
+        shadow.change_detector.fetcher = replay
+        shadow.change_detector._missing = dict(self.primary.change_detector._missing)
+        shadow.smtp = shadow.slack = shadow.webhook = None  # Dry-run 에서도 실제 발송 경로에 닿지 않도록
+        shadow_capture = RunCapture(shadow)
+
+        logger.info(f"シャドー実行開始: 記録済みレスポンス{len(recorded)}件, 設定 {self.config_dir}")
+        error = None
+        try:
+            shadow.main_process(dry_run=True)
+        except Exception as e:
+            error = str(e)
+            logger.error(f"シャドー実行エラー: {error}")
+
+        report = self.compare(primary_capture, shadow_capture, primary_stages, shadow.memory.stages)
+        report.update({'at': clock.now(JST).isoformat(), 'tenant': self.primary.tenant,
+                       'config_dir': self.config_dir, 'overrides': self.overrides,
+                       'replayed': len(recorded), 'replay_misses': replay.misses[:SAMPLE_LIMIT], 'error': error})
+        self.write(report)
+        return report
+
+    def compare(self, primary: RunCapture, shadow: RunCapture, primary_stages: Dict, shadow_stages: Dict) -> Dict:
+        only_primary = sorted(set(primary.items) - set(shadow.items))
+        only_shadow = sorted(set(shadow.items) - set(primary.items))
+        notification_keys = set(primary.notifications) | set(shadow.notifications)
+
+        stages = {}
+        for name in sorted(set(primary_stages) | set(shadow_stages)):
+            a, b = primary_stages.get(name, {}), shadow_stages.get(name, {})
+            stages[name] = {metric: {'primary': round(a.get(metric, 0.0), 3), 'shadow': round(b.get(metric, 0.0), 3)}
+                            for metric in ('seconds', 'allocated_mb', 'peak_mb')}
+
+        return {
+            'items': {
+                'primary': len(primary.items), 'shadow': len(shadow.items),
+                'only_primary': [primary.items[key] for key in only_primary[:SAMPLE_LIMIT]],
+                'only_shadow': [shadow.items[key] for key in only_shadow[:SAMPLE_LIMIT]],
+                'only_primary_count': len(only_primary), 'only_shadow_count': len(only_shadow),
+            },
+            'notifications': {
+                'primary': len(primary.notifications), 'shadow': len(shadow.notifications),
+                'only_primary': [list(key[:2]) for key in notification_keys - set(shadow.notifications)][:SAMPLE_LIMIT],
+                'only_shadow': [list(key[:2]) for key in notification_keys - set(primary.notifications)][:SAMPLE_LIMIT],
+                'summary_changed': sum(1 for key in notification_keys
+                                       if key in primary.notifications and key in shadow.notifications
+                                       and primary.notifications[key] != shadow.notifications[key]),
+            },
+            'stages': stages,
+        }
+
+    def write(self, report: Dict):
+        items, notifications = report['items'], report['notifications']
+        logger.info(f"シャドー比較: 項目 {items['primary']}→{items['shadow']}件 "
+                    f"(運用のみ{items['only_primary_count']}, シャドーのみ{items['only_shadow_count']}), "
+                    f"通知 {notifications['primary']}→{notifications['shadow']}件 "
+                    f"(本文変化{notifications['summary_changed']})")
+        for name, stage in report['stages'].items():
+            logger.info(f"シャドー比較[{name}]: {stage['seconds']['primary']:.2f}秒→{stage['seconds']['shadow']:.2f}秒, "
+                        f"ピーク {stage['peak_mb']['primary']:.1f}MB→{stage['peak_mb']['shadow']:.1f}MB")
+        try:
+            with open(self.report_path, 'a', encoding='utf-8') as f:
+                f.write(json.dumps(report, ensure_ascii=False, default=str) + '\n')
+        except OSError as e:
+            logger.error(f"シャドー比較結果の出力エラー: {str(e)}")
+
+
+def main():
+    """운영 측도 Dry-run 으로 1회 실행하고 대체 설정과 비교"""
+    system = SeminarAutomationSystem()
+    runner = ShadowRunner(system)
+    runner.prepare()
+    try:
+        system.main_process(dry_run=True)
+    finally:
+        report = runner.run()
+    print(json.dumps(report, ensure_ascii=False, indent=2, default=str))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - Slack 스레드・제자리 갱신 모드
+Author: Manus AI
+Date: 2025-09-26
+
+지역 요약・상태 변경마다 새 메시지를 올리는 대신, 채널・주제(지역)・일자별 부모 메시지를 1개 유지한다.
+- thread: 첫 항목은 부모 메시지, 이후 신규・상태 변경 항목은 스레드 답글
+- update: 신규・상태 변경 항목을 부모 메시지에 합쳐 chat.update
+같은 채널로 가는 발송(같은 지역의 여러 구독자, 재실행)은 짧은 창(SLACK_BATCH_SECONDS) 안에서 묶어
+부모 1건당 API 호출 1회로 처리하고, 이미 올린 항목(같은 URL・같은 내용)은 다시 보내지 않는다.
+
+Bot Token + 채널명 주소에만 적용 (Incoming Webhook 은 스레드・갱신을 지원하지 않아 기존대로 1건씩 발송).
+
+설정:
+    SLACK_MODE=thread              # message(기본, 기존 동작) | thread | update
+    SLACK_BATCH_SECONDS=30
+"""
+
+import os
+import json
+import sqlite3
+import logging
+import threading
+from collections import OrderedDict
+from datetime import timedelta
+from typing import Callable, Dict, List, Optional, Tuple
+
+import pytz
+
+from senders import SlackSender
+import clock
+
+logger = logging.getLogger(__name__)
+
+JST = pytz.timezone('Asia/Tokyo')
+
+MODES = ('thread', 'update')
+MAX_PARENT_LINES = 50  # update 모드 부모 메시지의 표시 상한 (Slack 본문 길이 제한 대비)
+RETENTION_DAYS = 30
+
+
+def seminar_line(seminar: Dict) -> str:
+    """항목 1건의 표시 행 (상태・개최일・장소가 바뀌면 다른 행 → 변경으로 취급)"""
+    event_date = seminar.get('event_date')
+    if event_date:
+        event_date = event_date[:10] if isinstance(event_date, str) else event_date.strftime('%Y-%m-%d')
+    date_str = f" [{event_date}]" if event_date else ""
+    location_str = f" @{seminar['location']}" if seminar.get('location') else ""
+    return f"• <{seminar['source_url']}|{seminar['title'][:80]}>{date_str}{location_str} ({seminar['status']})"
+
+
+class SlackThreads:
+    """채널・주제・일자별 부모 메시지 관리와 발송 묶음 처리"""
+
+    def __init__(self, connect: Callable[[], sqlite3.Connection], sender: Callable[[], SlackSender], mode: str,
+                 window_seconds: float = 30.0):
+        if mode not in MODES:
+            raise ValueError(f"不正なSLACK_MODE: {mode}")
+        self.connect = connect  # 실행 컨텍스트의 DB 연결 (DB_TIMEOUT 적용)
+        self.sender = sender  # 시뮬레이션 등에서 발송 계층을 교체해도 반영되도록 호출 시점에 취득
+        self.mode = mode
+        self.window_seconds = window_seconds
+        # (채널, 주제, 일자) → URL → 표시 행 (창 안에서 합쳐진 대기분)
+        self._pending: Dict[Tuple[str, str, str], 'OrderedDict[str, str]'] = {}
+        self._first_at: Optional[float] = None
+        self._lock = threading.Lock()
+        self.stats = {'parents': 0, 'replies': 0, 'updates': 0, 'skipped': 0, 'failed': 0}
+        # (채널, 주제) → 오류 (성공・변경 없음은 None), 대기 발송의 최종 결과 확인용 (take_outcomes)
+        self.outcomes: Dict[Tuple[str, str], Optional[str]] = {}
+
+    @classmethod
+    def from_env(cls, connect: Callable[[], sqlite3.Connection], sender: Callable[[], SlackSender]) -> Optional['SlackThreads']:
+        mode = os.getenv('SLACK_MODE', 'message').lower()
+        if mode == 'message':
+            return None
+        return cls(connect, sender, mode, float(os.getenv('SLACK_BATCH_SECONDS', '30')))
+
+    def enqueue(self, channel: str, topic: str, seminars: List[Dict]):
+        """발송 대기열에 추가 (창이 지났으면 그때까지의 대기분을 발송)"""
+        day = clock.now(JST).date().isoformat()
+        with self._lock:
+            items = self._pending.setdefault((channel, topic, day), OrderedDict())
+            for seminar in seminars:
+                items[seminar['source_url']] = seminar_line(seminar)
+            if self._first_at is None:
+                self._first_at = clock.time()
+            due = clock.time() - self._first_at >= self.window_seconds
+        if due:
+            self.flush()
+
+    def flush(self) -> Tuple[int, int]:
+        """대기분 발송 → (성공 API 호출 수, 실패 수)"""
+        with self._lock:
+            pending, self._pending = self._pending, {}
+            self._first_at = None
+        if not pending:
+            return 0, 0
+
+        ok = failed = 0
+        conn = self.connect()
+        try:
+            for (channel, topic, day), items in pending.items():
+                row = conn.execute('SELECT channel_id, ts, items FROM slack_threads WHERE channel = ? AND topic = ? AND day = ?',
+                                   (channel, topic, day)).fetchone()
+                posted = json.loads(row[2]) if row else {}
+                changed = OrderedDict((url, line) for url, line in items.items() if posted.get(url) != line)
+                if not changed:
+                    self.stats['skipped'] += 1
+                    self._outcome(channel, topic, None)
+                    continue
+
+                channel_id, ts, error = self._deliver(channel, topic, day, row, posted, changed)
+                self._outcome(channel, topic, error)
+                if error:
+                    failed += 1
+                    self.stats['failed'] += 1
+                    logger.error(f"Slackスレッド送信失敗: {channel} {topic} - {error}")
+                    continue
+                ok += 1
+                posted.update(changed)
+                with conn:
+                    conn.execute('''
+                        INSERT OR REPLACE INTO slack_threads (channel, topic, day, channel_id, ts, items, updated_at)
+                        VALUES (?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)
+                    ''', (channel, topic, day, channel_id, ts, json.dumps(posted, ensure_ascii=False)))
+
+            cutoff = (clock.now(JST).date() - timedelta(days=RETENTION_DAYS)).isoformat()
+            with conn:
+                conn.execute('DELETE FROM slack_threads WHERE day < ?', (cutoff,))
+        finally:
+            conn.close()
+
+        logger.info(f"Slackスレッド送信: 親{self.stats['parents']}件・返信{self.stats['replies']}件・"
+                    f"更新{self.stats['updates']}件・変更なし{self.stats['skipped']}件・失敗{self.stats['failed']}件 "
+                    f"(累計API呼び出し {getattr(self.sender(), 'api_calls', 0)}回)")
+        return ok, failed
+
+    def _outcome(self, channel: str, topic: str, error: Optional[str]):
+        # 한 실행에서 같은 채널・주제의 발송이 여러 번 나뉘면 실패를 우선
+        with self._lock:
+            if self.outcomes.get((channel, topic)) is None:
+                self.outcomes[(channel, topic)] = error
+
+    def take_outcomes(self) -> Dict[Tuple[str, str], Optional[str]]:
+        """지금까지 발송한 (채널, 주제)별 결과를 꺼내고 초기화"""
+        with self._lock:
+            outcomes, self.outcomes = self.outcomes, {}
+        return outcomes
+
+    def _deliver(self, channel: str, topic: str, day: str, row: Optional[tuple],
+                 posted: Dict[str, str], changed: Dict[str, str]) -> Tuple[Optional[str], Optional[str], Optional[str]]:
+        """부모 메시지 작성 / 스레드 답글 / 부모 갱신 → (채널 ID, 부모 ts, 오류)"""
+        sender = self.sender()
+        if row is None:
+            ts, channel_id, error = sender.post(channel, self._parent_text(topic, day, changed))
+            if not error:
+                self.stats['parents'] += 1
+            return channel_id, ts, error
+
+        channel_id, ts = row[0], row[1]
+        if self.mode == 'update':
+            ok, error = sender.update(channel_id, ts, self._parent_text(topic, day, {**posted, **changed}))
+            if ok:
+                self.stats['updates'] += 1
+            return channel_id, ts, error
+
+        updated = [line for url, line in changed.items() if url in posted]
+        added = [line for url, line in changed.items() if url not in posted]
+        parts = []
+        if added:
+            parts.append(f"신착 {len(added)}건:\n" + '\n'.join(added))
+        if updated:
+            parts.append(f"상태 변경 {len(updated)}건:\n" + '\n'.join(updated))
+        reply_ts, _, error = sender.post(channel, '\n\n'.join(parts), thread_ts=ts)
+        if not error:
+            self.stats['replies'] += 1
+        return channel_id, ts, error
+
+    def _parent_text(self, topic: str, day: str, items: Dict[str, str]) -> str:
+        lines = list(items.values())
+        shown = lines[:MAX_PARENT_LINES]
+        more = f"\n…외 {len(lines) - len(shown)}건" if len(lines) > len(shown) else ""
+        return (f"*해기사 세미나 정보 - {topic} ({day}) {len(lines)}건*\n" + '\n'.join(shown) + more +
+                f"\n\n최종 갱신: {clock.now(JST).strftime('%H:%M')}")
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 정보원별 항목 스냅샷 차분
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import hashlib
+import logging
+import sqlite3
+import threading
+from typing import Callable, Dict, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+
+def fingerprint(text: str) -> str:
+    """항목 내용 지문"""
+    return hashlib.sha1(text.encode('utf-8')).hexdigest()
+
+
+class PageDelta:
+    """이전 실행 대비 추가・변경・삭제된 항목 키"""
+
+    def __init__(self, added: List[str], changed: List[str], removed: List[str], unchanged: int, full: bool):
+        self.added = added
+        self.changed = changed
+        self.removed = removed
+        self.unchanged = unchanged
+        self.full = full
+
+    @property
+    def keys(self) -> set:
+        """하류로 보낼 항목 키"""
+        return set(self.added) | set(self.changed)
+
+    def __str__(self) -> str:
+        mode = '全件' if self.full else '差分'
+        return (f"{mode}: 追加 {len(self.added)}, 変更 {len(self.changed)}, "
+                f"削除 {len(self.removed)}, 変更なし {self.unchanged}")
+
+
+class Validators:
+    """재취득 판정용 정보 (HTTP 검증자와 sitemap lastmod)"""
+
+    def __init__(self, config_fingerprint: str = None, etag: str = None,
+                 last_modified: str = None, lastmod: str = None):
+        self.config_fingerprint = config_fingerprint
+        self.etag = etag
+        self.last_modified = last_modified
+        self.lastmod = lastmod
+
+
+class SnapshotStore:
+    """정보원 URL별 마지막 추출 항목 지문 맵 (처리 완료 후 일괄 확정)"""
+
+    def __init__(self, connect: Callable[[], sqlite3.Connection]):
+        self.connect = connect  # 실행 컨텍스트의 DB 연결 (DB_TIMEOUT 적용)
+        # url → (config_fingerprint, items, validators), items가 None이면 검증자만 갱신
+        self._pending: Dict[str, Tuple[str, Optional[Dict[str, str]], Validators]] = {}
+        self._lock = threading.Lock()
+
+    def load(self, url: str) -> Tuple[str, Dict[str, str]]:
+        conn = self.connect()
+        try:
+            row = conn.execute('SELECT config_fingerprint FROM source_snapshots WHERE url = ?', (url,)).fetchone()
+            if not row:
+                return None, {}
+            items = dict(conn.execute(
+                'SELECT item_key, fingerprint FROM source_items WHERE url = ?', (url,)).fetchall())
+            return row[0], items
+        finally:
+            conn.close()
+
+    def validators(self, url: str) -> Validators:
+        """마지막으로 확정된 스냅샷의 검증자"""
+        conn = self.connect()
+        try:
+            row = conn.execute('''
+                SELECT s.config_fingerprint, v.etag, v.last_modified, v.lastmod
+                FROM source_snapshots s LEFT JOIN source_validators v ON v.url = s.url
+                WHERE s.url = ?
+            ''', (url,)).fetchone()
+        finally:
+            conn.close()
+        return Validators(*row) if row else Validators()
+
+    def diff(self, url: str, items: Dict[str, str], config_fingerprint: str,
+             validators: Optional[Validators] = None) -> PageDelta:
+        """현재 항목 맵과 이전 스냅샷 비교 (설정이 바뀌었으면 전체를 다시 처리)"""
+        previous_config, previous = self.load(url)
+
+        added = [key for key in items if key not in previous]
+        changed = [key for key, fp in items.items() if key in previous and previous[key] != fp]
+        removed = [key for key in previous if key not in items]
+        unchanged = len(items) - len(added) - len(changed)
+
+        full = previous_config != config_fingerprint
+        if full:
+            # 키워드 테이블이 바뀌면 변경 없는 항목도 판정 결과가 달라질 수 있음
+            added = [key for key in items if key not in changed]
+            unchanged = 0
+
+        with self._lock:
+            self._pending[url] = (config_fingerprint, items, validators or Validators())
+        return PageDelta(added, changed, removed, unchanged, full)
+
+    def keep(self, url: str, validators: Validators):
+        """본문 미변경 (304 등): 항목 스냅샷은 유지하고 검증자만 갱신"""
+        with self._lock:
+            self._pending[url] = (None, None, validators)
+
+    def commit(self):
+        """이번 실행의 스냅샷 확정"""
+        with self._lock:
+            pending, self._pending = self._pending, {}
+        if not pending:
+            return
+
+        conn = self.connect()
+        try:
+            with conn:
+                for url, (config_fingerprint, items, validators) in pending.items():
+                    if items is not None:
+                        conn.execute('DELETE FROM source_items WHERE url = ?', (url,))
+                        conn.executemany(
+                            'INSERT INTO source_items (url, item_key, fingerprint) VALUES (?, ?, ?)',
+                            [(url, key, fp) for key, fp in items.items()])
+                        conn.execute('''
+                            INSERT OR REPLACE INTO source_snapshots (url, config_fingerprint, item_count, updated_at)
+                            VALUES (?, ?, ?, CURRENT_TIMESTAMP)
+                        ''', (url, config_fingerprint, len(items)))
+                    conn.execute('''
+                        INSERT OR REPLACE INTO source_validators (url, etag, last_modified, lastmod)
+                        VALUES (?, ?, ?, ?)
+                    ''', (url, validators.etag, validators.last_modified, validators.lastmod))
+        finally:
+            conn.close()
+
+    def discard(self):
+        """처리 실패 시 스냅샷을 갱신하지 않음 (다음 실행에서 다시 처리)"""
+        with self._lock:
+            self._pending = {}
@@ -12,6 +12,13 @@ if [ ! -f ".env" ]; then
     exit 1
 fi
 
+# 設定ディレクトリ確認（無いと空ディレクトリがマウントされて起動に失敗する）
+if [ ! -f "config/regional_transport_bureaus.json" ]; then
+    echo "❌ 設定ディレクトリ(./config)が見つかりません"
+    echo "💡 ./install.sh を実行するとイメージの既定値から作成されます"
+    exit 1
+fi
+
 # システム開始
 docker-compose -f docker-compose.production.yml up -d
 
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 멀티 테넌트 스케줄러
+Author: Manus AI
+Date: 2025-09-26
+
+하나의 스케줄러 프로세스에서 여러 테넌트(고객 선단별 설정)를 실행한다.
+- 테넌트별: 정보원・키워드 설정 디렉터리, 구독자・스냅샷 DB, 메인 프로세스 시각, 알림
+- 공유: 프로세스 공통 실행 컨텍스트(runtime.Runtime) - HTTP 취득 계층(커넥션 풀・호스트별 동시성 상한・
+  실행 내 동일 요청 합치기), SMTP 연결 풀・Slack 세션・Webhook 연결 풀, 관련도 모델(테넌트별 모델 파일), 작업 실행기,
+  메모리 예산(프로세스 RSS 기준, 테넌트가 동시에 돌면 단계별 할당량은 기록하지 않음)
+- 공정성: 작업 실행기의 워커를 테넌트 간 라운드 로빈으로 배정
+
+테넌트 목록 (TENANTS_FILE, JSON):
+    [{"name": "fleet-a", "config_dir": "/app/tenants/fleet-a", "main_at": "09:00"},
+     {"name": "fleet-b", "config_dir": "/app/tenants/fleet-b", "db_path": "/app/data/fleet-b.db"}]
+"""
+
+import os
+import re
+import json
+import time
+import logging
+from typing import Dict, List, Optional
+
+import schedule
+
+from admin_server import AdminServer
+from runtime import Runtime
+from seminar_automation_system import SeminarAutomationSystem
+from seminar_scheduler import SeminarScheduler
+
+logger = logging.getLogger(__name__)
+
+TENANT_NAME_PATTERN = re.compile(r'^[A-Za-z0-9_-]+$')
+
+
+def load_tenants(path: str, data_dir: str) -> List[Dict]:
+    """테넌트 목록 로드 (이름은 작업명・URL 경로에 쓰이므로 영숫자・'-'・'_' 만 허용)"""
+    with open(path, 'r', encoding='utf-8') as f:
+        tenants = json.load(f)
+
+    names = set()
+    for tenant in tenants:
+        name = tenant.get('name', '')
+        if not TENANT_NAME_PATTERN.match(name):
+            raise ValueError(f"不正なテナント名: {name!r}")
+        if name in names:
+            raise ValueError(f"テナント名が重複しています: {name}")
+        if not tenant.get('config_dir'):
+            raise ValueError(f"config_dir が未指定です: {name}")
+        names.add(name)
+        tenant.setdefault('db_path', os.path.join(data_dir, f'{name}.db'))
+        tenant.setdefault('main_at', '09:00')
+    return tenants
+
+
+class TenantHost:
+    """테넌트별 SeminarScheduler 를 공유 자원 위에서 실행"""
+
+    def __init__(self, tenants_file: Optional[str] = None, runtime: Runtime = None):
+        self.runtime = runtime or Runtime.current()
+        self.schedulers: Dict[str, SeminarScheduler] = {}
+        self.tenants = load_tenants(tenants_file or self.runtime.settings.tenants_file,
+                                    self.runtime.settings.tenant_data_dir)
+        self.admin_server = None
+
+        memory = self.runtime.memory
+        for tenant in self.tenants:
+            rss_before = memory.current_rss_mb()
+            self.add(tenant)
+            logger.info(f"テナント追加: {tenant['name']} ({tenant['config_dir']}, "
+                        f"RSS +{memory.current_rss_mb() - rss_before:.1f}MB)")
+
+    def add(self, tenant: Dict) -> SeminarScheduler:
+        name = tenant['name']
+        os.makedirs(os.path.dirname(tenant['db_path']) or '.', exist_ok=True)
+        system = SeminarAutomationSystem(db_path=tenant['db_path'], config_dir=tenant['config_dir'],
+                                         runtime=self.runtime, tenant=name)
+        scheduler = SeminarScheduler(system=system, tenant=name)
+        self.schedulers[name] = scheduler
+        return scheduler
+
+    def setup_schedule(self, dry_run: bool = True):
+        for tenant in self.tenants:
+            self.schedulers[tenant['name']].setup_schedule(dry_run=dry_run, main_at=tenant['main_at'])
+
+    def start_admin_server(self):
+        """관리 서버 (/metrics 공통, /calendar/<테넌트>/<토큰>.ics, /tenants)"""
+        self.admin_server = AdminServer()
+        for name, scheduler in self.schedulers.items():
+            scheduler.system.calendar.refresh_fragments()
+            self.admin_server.add_route(f'/calendar/{name}/', scheduler.system.calendar.endpoint, prefix=True)
+        self.admin_server.add_route('/metrics', self.metrics_endpoint, protected=True)
+        self.admin_server.add_route('/tenants', self.tenants_endpoint, protected=True)
+        try:
+            self.admin_server.start()
+        except OSError as e:
+            logger.error(f"管理サーバー開始エラー: {str(e)}")
+
+    def metrics_endpoint(self, query: dict, headers: dict):
+        """/metrics - 공유 취득 계층 + 테넌트별 알림 지표 (tenant 라벨)"""
+        lines = self.runtime.metrics()
+        for index, (name, scheduler) in enumerate(self.schedulers.items()):
+            for line in scheduler.system.alerts.metrics(labels=f'{{tenant="{name}"}}'):
+                if index and line.startswith('#'):
+                    continue  # HELP・TYPE 는 1회만
+                lines.append(line)
+        return 200, 'text/plain; version=0.0.4', '\n'.join(lines) + '\n'
+
+    def tenants_endpoint(self, query: dict, headers: dict):
+        """/tenants - 테넌트별 마지막 실행 결과・실행 중 작업"""
+        running = self.runtime.executor.running()
+        return 200, 'application/json', [
+            {'name': name, 'db_path': scheduler.system.db_path, 'config_dir': scheduler.system.config_dir,
+             'last_execution_status': scheduler.last_execution_status,
+             'running': running.get(f'{name}/main', [])}
+            for name, scheduler in self.schedulers.items()]
+
+    def run(self, dry_run: bool = True):
+        """스케줄러 실행 (모든 테넌트의 작업을 하나의 schedule 루프에서 투입)"""
+        self.setup_schedule(dry_run=dry_run)
+        self.start_admin_server()
+
+        logger.info(f"マルチテナントスケジューラー開始: {len(self.schedulers)}テナント")
+
+        try:
+            while True:
+                # 테넌트별 설정 재로드는 각 run_main_process 시작 시에만
+                schedule.run_pending()
+                time.sleep(60)  # 1분마다 스케줄 확인
+
+        except KeyboardInterrupt:
+            logger.info("スケジューラーがユーザーによって停止されました")
+        except Exception as e:
+            logger.error(f"スケジューラー実行中エラー: {str(e)}")
+        finally:
+            self.runtime.close()
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 항목별 트레이싱
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import json
+import time
+import logging
+from contextlib import contextmanager
+from typing import Dict, List, Optional
+import requests
+
+logger = logging.getLogger(__name__)
+
+SERVICE_NAME = 'seminar-automation'
+
+
+class Span:
+    """단일 처리 단계 (시작/종료 시각은 Unix 나노초)"""
+
+    def __init__(self, name: str, start_ns: int, end_ns: int = None, attributes: Dict = None):
+        self.name = name
+        self.span_id = os.urandom(8).hex()
+        self.start_ns = start_ns
+        self.end_ns = end_ns
+        self.attributes = dict(attributes or {})
+
+    def set(self, key: str, value):
+        """판정 결과 등 속성 기록"""
+        self.attributes[key] = value
+
+    def to_dict(self) -> Dict:
+        return {
+            'name': self.name,
+            'start_ns': self.start_ns,
+            'duration_ms': round((self.end_ns - self.start_ns) / 1e6, 3),
+            'attributes': self.attributes
+        }
+
+
+class ItemTrace:
+    """세미나 1건의 수집부터 발송까지의 트레이스"""
+
+    def __init__(self, item_key: str, attributes: Dict = None):
+        self.trace_id = os.urandom(16).hex()
+        self.item_key = item_key
+        self.attributes = dict(attributes or {})
+        self.spans: List[Span] = []
+        self.outcome = None
+        self.finished = False
+
+    def add_span(self, name: str, start_ns: int, end_ns: int, attributes: Dict = None) -> Span:
+        """페이지 단위로 측정한 단계(fetch/parse 등)를 항목 트레이스에 추가"""
+        span = Span(name, start_ns, end_ns, attributes)
+        self.spans.append(span)
+        return span
+
+    @contextmanager
+    def span(self, name: str, **attributes):
+        """항목 단위 단계 측정"""
+        span = Span(name, time.time_ns(), attributes=attributes)
+        try:
+            yield span
+        except Exception as e:
+            span.set('error', str(e))
+            raise
+        finally:
+            span.end_ns = time.time_ns()
+            self.spans.append(span)
+
+    def finish(self, outcome: str):
+        """최종 결과 확정 (이후 변경 불가)"""
+        if not self.finished:
+            self.outcome = outcome
+            self.finished = True
+
+    def to_dict(self) -> Dict:
+        start_ns = min((s.start_ns for s in self.spans), default=0)
+        end_ns = max((s.end_ns for s in self.spans), default=0)
+        return {
+            'trace_id': self.trace_id,
+            'item': self.item_key,
+            'attributes': self.attributes,
+            'outcome': self.outcome or 'incomplete',
+            'duration_ms': round((end_ns - start_ns) / 1e6, 3),
+            'spans': [s.to_dict() for s in self.spans]
+        }
+
+
+class Tracer:
+    """실행 단위로 트레이스를 모아 JSON 파일 또는 OTLP 수집기로 내보냄 (기본은 비활성)"""
+
+    def __init__(self, exporter: str = None, file_path: str = None, otlp_endpoint: str = None):
+        self.exporter = (exporter or os.getenv('TRACE_EXPORTER', 'none')).lower()
+        self.file_path = file_path or os.getenv('TRACE_FILE', '/app/logs/traces.jsonl')
+        # JSON 파일은 크기 상한을 넘으면 .1, .2 ... 로 교체 (오래된 것부터 삭제)
+        self.file_max_bytes = int(float(os.getenv('TRACE_FILE_MAX_MB', '50')) * 1024 * 1024)
+        self.file_backups = int(os.getenv('TRACE_FILE_BACKUPS', '3'))
+        self.otlp_endpoint = otlp_endpoint or os.getenv('OTEL_EXPORTER_OTLP_ENDPOINT', 'http://localhost:4318')
+        self.traces: List[ItemTrace] = []
+
+    @property
+    def enabled(self) -> bool:
+        return self.exporter in ('json', 'otlp')
+
+    def start_trace(self, item_key: str, **attributes) -> ItemTrace:
+        trace = ItemTrace(item_key, attributes)
+        if self.enabled:
+            self.traces.append(trace)
+        return trace
+
+    def flush(self):
+        """수집한 트레이스를 내보내고 비움"""
+        traces, self.traces = self.traces, []
+        if not traces:
+            return
+
+        try:
+            if self.exporter == 'otlp':
+                self._export_otlp(traces)
+            else:
+                self._export_json(traces)
+            logger.info(f"トレース出力完了: {len(traces)}件 ({self.exporter})")
+        except Exception as e:
+            logger.error(f"トレース出力エラー: {str(e)}")
+
+    def _export_json(self, traces: List[ItemTrace]):
+        self._rotate_if_needed()
+        with open(self.file_path, 'a', encoding='utf-8') as f:
+            for trace in traces:
+                f.write(json.dumps(trace.to_dict(), ensure_ascii=False, default=str) + '\n')
+
+    def _rotate_if_needed(self):
+        try:
+            if os.path.getsize(self.file_path) < self.file_max_bytes:
+                return
+        except OSError:
+            return
+        for index in range(self.file_backups - 1, 0, -1):
+            source = f"{self.file_path}.{index}"
+            if os.path.exists(source):
+                os.replace(source, f"{self.file_path}.{index + 1}")
+        if self.file_backups > 0:
+            os.replace(self.file_path, f"{self.file_path}.1")
+        else:
+            os.remove(self.file_path)
+        logger.info(f"トレースファイルをローテーション: {self.file_path}")
+
+    def _export_otlp(self, traces: List[ItemTrace]):
+        spans = []
+        for trace in traces:
+            root_id = os.urandom(8).hex()
+            start_ns = min((s.start_ns for s in trace.spans), default=time.time_ns())
+            end_ns = max((s.end_ns for s in trace.spans), default=start_ns)
+            root_attributes = dict(trace.attributes, item=trace.item_key, outcome=trace.outcome or 'incomplete')
+            spans.append(self._otlp_span(trace.trace_id, root_id, None, 'item', start_ns, end_ns, root_attributes))
+            for span in trace.spans:
+                spans.append(self._otlp_span(trace.trace_id, span.span_id, root_id, span.name,
+                                             span.start_ns, span.end_ns, span.attributes))
+
+        payload = {
+            'resourceSpans': [{
+                'resource': {'attributes': [self._otlp_attribute('service.name', SERVICE_NAME)]},
+                'scopeSpans': [{'scope': {'name': __name__}, 'spans': spans}]
+            }]
+        }
+        response = requests.post(f"{self.otlp_endpoint.rstrip('/')}/v1/traces", json=payload, timeout=10)
+        response.raise_for_status()
+
+    def _otlp_span(self, trace_id: str, span_id: str, parent_id: Optional[str], name: str,
+                   start_ns: int, end_ns: int, attributes: Dict) -> Dict:
+        span = {
+            'traceId': trace_id,
+            'spanId': span_id,
+            'name': name,
+            'kind': 1,
+            'startTimeUnixNano': str(start_ns),
+            'endTimeUnixNano': str(end_ns),
+            'attributes': [self._otlp_attribute(k, v) for k, v in attributes.items()]
+        }
+        if parent_id:
+            span['parentSpanId'] = parent_id
+        return span
+
+    def _otlp_attribute(self, key: str, value) -> Dict:
+        if isinstance(value, bool):
+            typed = {'boolValue': value}
+        elif isinstance(value, int):
+            typed = {'intValue': str(value)}
+        elif isinstance(value, float):
+            typed = {'doubleValue': value}
+        else:
+            typed = {'stringValue': str(value)}
+        return {'key': key, 'value': typed}
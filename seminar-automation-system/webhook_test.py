@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - Webhook 서명 확인 테스트
+Author: Manus AI
+Date: 2025-09-26
+
+로컬 스텁 수신 서버(127.0.0.1)를 띄우고 WebhookSender 로 실제 POST 를 보내
+X-Seminar-Signature 헤더가 WEBHOOK_SECRET 으로 검증되는지 확인한다 (외부 접속 없음).
+- 서명: 수신 측과 같은 계산(sign)으로 일치, 다른 시크릿으로는 불일치
+- 재시도: 503 후 재전송해도 X-Seminar-Delivery 가 같고 서명은 새 타임스탬프로 다시 계산
+- 시크릿 미설정: 서명 없는 POST 를 보내지 않음
+
+    python webhook_test.py
+"""
+
+import os
+import sys
+import json
+import logging
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+# 송신 설정은 WebhookSender 생성 시 환경 변수에서 읽음
+os.environ.setdefault('WEBHOOK_SECRET', 'webhook-test-secret')
+os.environ['WEBHOOK_RETRIES'] = '1'
+os.environ['WEBHOOK_BACKOFF_SECONDS'] = '0.01'
+
+from webhooks import SIGNATURE_HEADER, TIMESTAMP_HEADER, DELIVERY_HEADER, WebhookSender, sign
+
+# 로그 설정
+logging.basicConfig(
+    level=logging.INFO,
+    format='%(asctime)s - %(levelname)s - %(message)s',
+    handlers=[
+        logging.StreamHandler()
+    ]
+)
+logger = logging.getLogger(__name__)
+
+
+class StubReceiver:
+    """수신 요청의 헤더・본문을 그대로 기록하는 스텁 (fail_first 건은 503 응답)"""
+
+    def __init__(self, fail_first: int = 0):
+        self.requests = []
+        self.fail_first = fail_first
+        self._lock = threading.Lock()
+        receiver = self
+
+        class Handler(BaseHTTPRequestHandler):
+            protocol_version = 'HTTP/1.1'
+
+            def do_POST(self):
+                body = self.rfile.read(int(self.headers.get('Content-Length', 0)))
+                with receiver._lock:
+                    receiver.requests.append((dict(self.headers), body))
+                    status = 503 if len(receiver.requests) <= receiver.fail_first else 200
+                self.send_response(status)
+                self.send_header('Content-Length', '0')
+                self.end_headers()
+
+            def log_message(self, *args):
+                pass
+
+        self.server = ThreadingHTTPServer(('127.0.0.1', 0), Handler)
+        self.server.daemon_threads = True
+        self.url = f"http://127.0.0.1:{self.server.server_address[1]}/hook"
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+    def close(self):
+        self.server.shutdown()
+        self.server.server_close()
+
+
+def sample_payload() -> dict:
+    return {
+        'delivery_id': 'webhook-test-0001',
+        'sent_at': '2025-10-01T09:00:00+09:00',
+        'tenant': None,
+        'batch': {'index': 1, 'count': 1},
+        'items': [{'seminar_id': 1, 'title': 'めざせ！海技者セミナー', 'status': '募集中',
+                   'event_date': '2025-11-10', 'location': '東京', 'source_url': 'https://example.jp/seminar/1',
+                   'topics': ['관동']}],
+    }
+
+
+def check_signature() -> bool:
+    """서명 헤더가 시크릿・타임스탬프・본문으로 검증되는지"""
+    secret = os.environ['WEBHOOK_SECRET']
+    receiver = StubReceiver()
+    try:
+        ok, error = WebhookSender().post(receiver.url, sample_payload())
+    finally:
+        receiver.close()
+
+    if not ok or len(receiver.requests) != 1:
+        logger.error(f"❌ 送信失敗: {error} (受信{len(receiver.requests)}件)")
+        return False
+    headers, body = receiver.requests[0]
+    signature = headers.get(SIGNATURE_HEADER)
+    expected = sign(secret, headers.get(TIMESTAMP_HEADER, ''), body)
+    if signature != expected:
+        logger.error(f"❌ 署名不一致: {signature} != {expected}")
+        return False
+    if sign(secret + '-wrong', headers[TIMESTAMP_HEADER], body) == signature:
+        logger.error("❌ 異なるシークレットでも署名が一致しました")
+        return False
+    if json.loads(body) != sample_payload():
+        logger.error("❌ 本文が送信内容と一致しません")
+        return False
+    logger.info(f"✅ 署名検証成功: {signature[:23]}...")
+    return True
+
+
+def check_retry() -> bool:
+    """503 후 재전송: 배치 ID 유지, 서명은 재전송 요청에 대해서도 유효"""
+    secret = os.environ['WEBHOOK_SECRET']
+    receiver = StubReceiver(fail_first=1)
+    try:
+        ok, error = WebhookSender().post(receiver.url, sample_payload())
+    finally:
+        receiver.close()
+
+    if not ok or len(receiver.requests) != 2:
+        logger.error(f"❌ 再試行失敗: {error} (受信{len(receiver.requests)}件)")
+        return False
+    deliveries = {headers.get(DELIVERY_HEADER) for headers, _ in receiver.requests}
+    if deliveries != {'webhook-test-0001'}:
+        logger.error(f"❌ 再試行で配信IDが変わりました: {deliveries}")
+        return False
+    for headers, body in receiver.requests:
+        if headers.get(SIGNATURE_HEADER) != sign(secret, headers.get(TIMESTAMP_HEADER, ''), body):
+            logger.error("❌ 再試行リクエストの署名が不正です")
+            return False
+    logger.info("✅ 再試行: 配信ID維持・署名有効")
+    return True
+
+
+def check_unsigned_refused() -> bool:
+    """시크릿이 없으면 요청 자체를 보내지 않음"""
+    receiver = StubReceiver()
+    secret = os.environ.pop('WEBHOOK_SECRET')
+    try:
+        ok, error = WebhookSender().post(receiver.url, sample_payload())
+    finally:
+        os.environ['WEBHOOK_SECRET'] = secret
+        receiver.close()
+
+    if ok or receiver.requests:
+        logger.error(f"❌ シークレット未設定でも送信されました (受信{len(receiver.requests)}件)")
+        return False
+    logger.info(f"✅ シークレット未設定時は送信拒否: {error}")
+    return True
+
+
+def main():
+    """メイン関数"""
+    print("=" * 60)
+    print("🚢 海技士セミナー情報 Webhook署名テスト")
+    print("=" * 60)
+
+    results = [check_signature(), check_retry(), check_unsigned_refused()]
+    if all(results):
+        logger.info("✅ テスト完了: Webhook署名はすべて検証できました")
+    else:
+        logger.error(f"❌ テスト失敗: {results.count(False)}/{len(results)}件")
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - 時計の差し替え
+Author: WaterwaySystem
+Date: 2025-09-26
+
+スケジュールに関わる現在時刻・待機はこのモジュール経由で取得する。
+通常は実時間（SystemClock）、シミュレーションでは VirtualClock に差し替え、
+数週間～1年分のスケジュールを数秒で進める。
+
+VirtualClock は離散イベント方式:
+- sleep() は仮想時刻が起床時刻に達するまでブロックする（自分では時計を進めない）
+- シミュレーション駆動側が、実行中のジョブが全て sleep 中か終了したのを確認してから
+  次のイベント（スケジュールの次回実行 or 最も早い起床時刻）まで時計を進める
+"""
+
+import time as _time
+import threading
+import datetime as _datetime
+from datetime import datetime, tzinfo
+from typing import Callable, List, Optional
+
+
+class SystemClock:
+    """実時間"""
+
+    def now(self, tz: Optional[tzinfo] = None) -> datetime:
+        return datetime.now(tz)
+
+    def time(self) -> float:
+        return _time.time()
+
+    def sleep(self, seconds: float):
+        _time.sleep(seconds)
+
+
+class VirtualClock(SystemClock):
+    """仮想時刻（駆動側が advance_to() で進める）"""
+
+    def __init__(self, start: datetime):
+        self._t = start.timestamp()
+        self._sleepers: List[float] = []  # 起床待ちの時刻
+        self._cond = threading.Condition()
+
+    def now(self, tz: Optional[tzinfo] = None) -> datetime:
+        # tz=None はプロセスのローカル時刻（schedule ライブラリと同じ扱い）
+        return datetime.fromtimestamp(self.time(), tz)
+
+    def time(self) -> float:
+        with self._cond:
+            return self._t
+
+    def sleep(self, seconds: float):
+        with self._cond:
+            if seconds <= 0:
+                return
+            wake_at = self._t + seconds
+            self._sleepers.append(wake_at)
+            self._cond.notify_all()
+            while self._t < wake_at:
+                self._cond.wait()
+
+    def sleeping(self) -> int:
+        with self._cond:
+            return len(self._sleepers)
+
+    def next_wake(self) -> Optional[float]:
+        with self._cond:
+            return min(self._sleepers) if self._sleepers else None
+
+    def advance_to(self, timestamp: float):
+        """時計を進め、起床時刻に達した sleep を解放"""
+        with self._cond:
+            if timestamp > self._t:
+                self._t = timestamp
+            self._sleepers = [wake_at for wake_at in self._sleepers if wake_at > self._t]
+            self._cond.notify_all()
+
+    def notify(self):
+        """ジョブ終了を駆動側に知らせる"""
+        with self._cond:
+            self._cond.notify_all()
+
+    def wait_quiescent(self, busy: Callable[[], int], timeout: float = 300.0) -> bool:
+        """実行中ジョブ数 busy() が全て sleep 中になるまで（実時間で）待つ"""
+        deadline = _time.monotonic() + timeout
+        with self._cond:
+            while len(self._sleepers) < busy():
+                remaining = deadline - _time.monotonic()
+                if remaining <= 0:
+                    return False
+                # sleep() 開始とジョブ終了（notify()）で起こされる。取りこぼしに備えて定期的にも再確認
+                self._cond.wait(min(remaining, 0.05))
+        return True
+
+
+class _ScheduleDatetime:
+    """schedule ライブラリ内の datetime.datetime.now() を差し替えるための代用モジュール"""
+
+    def __init__(self, clock: SystemClock):
+        class _Datetime(_datetime.datetime):
+            @classmethod
+            def now(cls, tz=None):
+                return clock.now(tz)
+
+        self.datetime = _Datetime
+        self.date = _datetime.date
+        self.time = _datetime.time
+        self.timedelta = _datetime.timedelta
+
+
+_clock: SystemClock = SystemClock()
+
+
+def install(clock: SystemClock):
+    """時計を差し替える（schedule ライブラリの現在時刻も同じ時計に揃える）"""
+    global _clock
+    _clock = clock
+
+    import schedule
+    schedule.datetime = _ScheduleDatetime(clock) if isinstance(clock, VirtualClock) else _datetime
+
+
+def current() -> SystemClock:
+    return _clock
+
+
+def now(tz: Optional[tzinfo] = None) -> datetime:
+    return _clock.now(tz)
+
+
+def time() -> float:
+    return _clock.time()
+
+
+def sleep(seconds: float):
+    _clock.sleep(seconds)
@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - データベースオンラインバックアップ
+Author: WaterwaySystem
+Date: 2025-09-26
+
+SQLiteのオンラインバックアップAPIでページ単位に少しずつコピーするため、
+バックアップ中も書き込み側が長時間ブロックされることはない。
+
+- ベースバックアップ: スナップショット全体をgzip圧縮して保存
+- アーカイブ: 前回スナップショットとの差分ページのみを保存
+- リストア: ベース + 指定時刻までのアーカイブを適用して任意時点を復元
+"""
+
+import os
+import sys
+import gzip
+import time
+import shutil
+import sqlite3
+import struct
+import logging
+import argparse
+from datetime import datetime
+from pathlib import Path
+from typing import List, Optional, Tuple
+import pytz
+
+import clock
+
+# 日本標準時の設定
+JST = pytz.timezone('Asia/Tokyo')
+
+logger = logging.getLogger(__name__)
+
+TIMESTAMP_FORMAT = '%Y%m%d_%H%M%S'
+BASE_SUFFIX = '.base.db.gz'
+DELTA_SUFFIX = '.delta.gz'
+MIRROR_NAME = '.mirror.db'
+
+# 差分アーカイブのヘッダー: ページサイズ, 総ページ数, 親スナップショット時刻
+DELTA_HEADER = struct.Struct('>QQ15s')
+DELTA_PAGE = struct.Struct('>Q')
+
+
+class DatabaseBackup:
+    def __init__(self, db_path: Optional[str] = None, backup_dir: Optional[str] = None,
+                 retention: Optional[int] = None, pages_per_step: Optional[int] = None,
+                 step_pause: Optional[float] = None):
+        self.db_path = db_path or os.getenv('DB_PATH', './data/waterway_notices.db')
+        self.backup_dir = Path(backup_dir or os.getenv('BACKUP_PATH', './data/backups'))
+        self.retention = retention or int(os.getenv('BACKUP_RETENTION_COUNT', '7'))
+        self.pages_per_step = pages_per_step or int(os.getenv('BACKUP_PAGES_PER_STEP', '64'))
+        self.step_pause = step_pause if step_pause is not None else float(os.getenv('BACKUP_STEP_PAUSE', '0.01'))
+        self.name = Path(self.db_path).stem
+        self.mirror_path = self.backup_dir / MIRROR_NAME
+
+    def snapshot(self, dest_path: Path) -> int:
+        """オンラインバックアップAPIでスナップショットを作成（ページ単位の段階コピー）"""
+        tmp_path = dest_path.with_suffix(dest_path.suffix + '.tmp')
+        if tmp_path.exists():
+            tmp_path.unlink()
+
+        def progress(status, remaining, total):
+            # ステップ間で読み取りロックを解放し、書き込み側に譲る
+            if remaining and self.step_pause > 0:
+                time.sleep(self.step_pause)
+
+        src = sqlite3.connect(self.db_path, timeout=5.0)
+        dst = sqlite3.connect(str(tmp_path))
+        try:
+            src.backup(dst, pages=self.pages_per_step, progress=progress)
+            result = dst.execute('PRAGMA quick_check').fetchone()[0]
+            if result != 'ok':
+                raise sqlite3.DatabaseError(f"スナップショット整合性チェック失敗: {result}")
+            # 差分計算をページ単位で行うため、スナップショットはロールバックジャーナルで保持する
+            dst.execute('PRAGMA journal_mode=DELETE')
+            page_count = dst.execute('PRAGMA page_count').fetchone()[0]
+        finally:
+            dst.close()
+            src.close()
+
+        os.replace(tmp_path, dest_path)
+        return page_count
+
+    def run_backup(self) -> Optional[Path]:
+        """ベースバックアップの作成"""
+        try:
+            self.backup_dir.mkdir(parents=True, exist_ok=True)
+            started = time.monotonic()
+            stamp = clock.now(JST).strftime(TIMESTAMP_FORMAT)
+
+            page_count = self.snapshot(self.mirror_path)
+            self._write_stamp(stamp)
+
+            base_path = self.backup_dir / f"{self.name}_{stamp}{BASE_SUFFIX}"
+            self._compress(self.mirror_path, base_path)
+
+            logger.info(f"ベースバックアップ完了: {base_path.name} "
+                        f"({page_count}ページ, {base_path.stat().st_size / 1024:.1f}KB, "
+                        f"{time.monotonic() - started:.2f}秒)")
+
+            self.apply_retention()
+            return base_path
+
+        except Exception as e:
+            logger.error(f"ベースバックアップ失敗: {str(e)}")
+            return None
+
+    def run_archive(self) -> Optional[Path]:
+        """前回スナップショットからの差分ページをアーカイブ"""
+        try:
+            if not self.mirror_path.exists() or not self._read_stamp():
+                logger.info("ベースバックアップが存在しないため、ベースバックアップを作成します")
+                return self.run_backup()
+
+            parent_stamp = self._read_stamp()
+            stamp = clock.now(JST).strftime(TIMESTAMP_FORMAT)
+            new_path = self.backup_dir / (MIRROR_NAME + '.new')
+
+            self.snapshot(new_path)
+            page_size, pages = self._diff_pages(self.mirror_path, new_path)
+
+            if not pages and new_path.stat().st_size == self.mirror_path.stat().st_size:
+                new_path.unlink()
+                logger.info("前回スナップショットから変更なし。アーカイブをスキップします")
+                return None
+
+            delta_path = self.backup_dir / f"{self.name}_{stamp}{DELTA_SUFFIX}"
+            total_pages = new_path.stat().st_size // page_size
+            tmp_path = delta_path.with_suffix('.tmp')
+            with open(new_path, 'rb') as src, gzip.open(tmp_path, 'wb') as out:
+                out.write(DELTA_HEADER.pack(page_size, total_pages, parent_stamp.encode('ascii')))
+                for page_no in pages:
+                    src.seek(page_no * page_size)
+                    out.write(DELTA_PAGE.pack(page_no))
+                    out.write(src.read(page_size))
+            os.replace(tmp_path, delta_path)
+
+            os.replace(new_path, self.mirror_path)
+            self._write_stamp(stamp)
+
+            logger.info(f"差分アーカイブ完了: {delta_path.name} ({len(pages)}/{total_pages}ページ)")
+            return delta_path
+
+        except Exception as e:
+            logger.error(f"差分アーカイブ失敗: {str(e)}")
+            return None
+
+    def restore(self, output_path: str, until: Optional[datetime] = None) -> bool:
+        """指定時刻時点のデータベースを復元（未指定時は最新）"""
+        until_stamp = until.astimezone(JST).strftime(TIMESTAMP_FORMAT) if until else None
+
+        bases = [(stamp, path) for stamp, path in self.list_backups(BASE_SUFFIX)
+                 if until_stamp is None or stamp <= until_stamp]
+        if not bases:
+            logger.error("復元可能なベースバックアップが見つかりません")
+            return False
+
+        base_stamp, base_path = bases[-1]
+        output = Path(output_path)
+        if output.exists():
+            logger.error(f"出力先が既に存在します: {output}")
+            return False
+
+        tmp_path = output.with_suffix(output.suffix + '.tmp')
+        with gzip.open(base_path, 'rb') as src, open(tmp_path, 'wb') as dst:
+            shutil.copyfileobj(src, dst)
+
+        applied = 0
+        parent = base_stamp
+        for stamp, delta_path in self.list_backups(DELTA_SUFFIX):
+            if stamp <= base_stamp or (until_stamp and stamp > until_stamp):
+                continue
+            if not self._apply_delta(delta_path, tmp_path, parent):
+                logger.warning(f"アーカイブの連鎖が途切れています: {delta_path.name}")
+                break
+            parent = stamp
+            applied += 1
+
+        conn = sqlite3.connect(str(tmp_path))
+        try:
+            result = conn.execute('PRAGMA integrity_check').fetchone()[0]
+        finally:
+            conn.close()
+        if result != 'ok':
+            tmp_path.unlink()
+            logger.error(f"復元データベースの整合性チェック失敗: {result}")
+            return False
+
+        os.replace(tmp_path, output)
+        logger.info(f"復元完了: {output} (ベース: {base_path.name}, アーカイブ{applied}件, 時点: {parent})")
+        return True
+
+    def apply_retention(self):
+        """保持世代数を超えたベースバックアップと、それより古いアーカイブを削除"""
+        bases = self.list_backups(BASE_SUFFIX)
+        expired = bases[:-self.retention] if len(bases) > self.retention else []
+        for _, path in expired:
+            path.unlink()
+            logger.info(f"古いバックアップを削除: {path.name}")
+
+        remaining = bases[len(expired):]
+        if not remaining:
+            return
+        oldest_stamp = remaining[0][0]
+        for stamp, path in self.list_backups(DELTA_SUFFIX):
+            if stamp <= oldest_stamp:
+                path.unlink()
+
+    def list_backups(self, suffix: str) -> List[Tuple[str, Path]]:
+        """時刻順のバックアップ一覧"""
+        if not self.backup_dir.exists():
+            return []
+        prefix = f"{self.name}_"
+        entries = []
+        for path in self.backup_dir.glob(f"{prefix}*{suffix}"):
+            stamp = path.name[len(prefix):-len(suffix)]
+            entries.append((stamp, path))
+        return sorted(entries)
+
+    def _diff_pages(self, old_path: Path, new_path: Path) -> Tuple[int, List[int]]:
+        conn = sqlite3.connect(str(new_path))
+        try:
+            page_size = conn.execute('PRAGMA page_size').fetchone()[0]
+        finally:
+            conn.close()
+
+        changed = []
+        with open(old_path, 'rb') as old, open(new_path, 'rb') as new:
+            page_no = 0
+            while True:
+                new_page = new.read(page_size)
+                if not new_page:
+                    break
+                if old.read(page_size) != new_page:
+                    changed.append(page_no)
+                page_no += 1
+        return page_size, changed
+
+    def _apply_delta(self, delta_path: Path, db_path: Path, expected_parent: str) -> bool:
+        with gzip.open(delta_path, 'rb') as src:
+            page_size, total_pages, parent = DELTA_HEADER.unpack(src.read(DELTA_HEADER.size))
+            if parent.decode('ascii') != expected_parent:
+                return False
+            with open(db_path, 'r+b') as dst:
+                while True:
+                    head = src.read(DELTA_PAGE.size)
+                    if not head:
+                        break
+                    (page_no,) = DELTA_PAGE.unpack(head)
+                    dst.seek(page_no * page_size)
+                    dst.write(src.read(page_size))
+                dst.truncate(total_pages * page_size)
+        return True
+
+    def _compress(self, src_path: Path, dest_path: Path):
+        tmp_path = dest_path.with_suffix('.tmp')
+        with open(src_path, 'rb') as src, gzip.open(tmp_path, 'wb') as dst:
+            shutil.copyfileobj(src, dst)
+        os.replace(tmp_path, dest_path)
+
+    def _read_stamp(self) -> Optional[str]:
+        stamp_path = self.backup_dir / (MIRROR_NAME + '.stamp')
+        if not stamp_path.exists():
+            return None
+        return stamp_path.read_text(encoding='ascii').strip()
+
+    def _write_stamp(self, stamp: str):
+        stamp_path = self.backup_dir / (MIRROR_NAME + '.stamp')
+        stamp_path.write_text(stamp, encoding='ascii')
+
+
+def main():
+    """コマンドライン実行"""
+    logging.basicConfig(
+        level=getattr(logging, os.getenv('LOG_LEVEL', 'INFO')),
+        format='%(asctime)s - %(name)s - %(levelname)s - %(message)s',
+        handlers=[logging.StreamHandler(sys.stdout)]
+    )
+
+    parser = argparse.ArgumentParser(description='水路通報データベースのバックアップ・復元')
+    parser.add_argument('command', choices=['backup', 'archive', 'restore', 'list'])
+    parser.add_argument('--output', help='復元先のデータベースファイル')
+    parser.add_argument('--until', help='復元時点 (例: 2025-09-26T06:30)')
+    args = parser.parse_args()
+
+    backup = DatabaseBackup()
+
+    if args.command == 'backup':
+        sys.exit(0 if backup.run_backup() else 1)
+    elif args.command == 'archive':
+        backup.run_archive()
+    elif args.command == 'restore':
+        if not args.output:
+            parser.error('restore には --output が必要です')
+        until = JST.localize(datetime.fromisoformat(args.until)) if args.until else None
+        sys.exit(0 if backup.restore(args.output, until) else 1)
+    elif args.command == 'list':
+        for suffix in (BASE_SUFFIX, DELTA_SUFFIX):
+            for stamp, path in backup.list_backups(suffix):
+                print(f"{stamp}  {path.name}  {path.stat().st_size / 1024:.1f}KB")
+
+
+if __name__ == "__main__":
+    main()
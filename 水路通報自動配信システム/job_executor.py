@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - ジョブ実行器
+Author: WaterwaySystem
+Date: 2025-09-26
+
+schedule.run_pending() からはジョブの投入だけを行い、実行はワーカープールで行う。
+- レーン: 長時間ジョブ（配信・ベースバックアップ）と短時間ジョブ（ヘルスチェック等）で
+  プールを分け、短いジョブが長いジョブの後ろで待たないようにする
+- グループ: 同時実行数の上限単位（同じDBに書き込む日次・週次は同一グループ）
+- 重複ポリシー: 上限に達しているときの新規投入の扱い
+    skip   : 破棄
+    queue  : 1件だけ保留し、実行中のものが終わったら実行（複数回の投入はまとめる）
+    cancel : 実行中のものに取消を通知し、終了後に新しいものを実行
+"""
+
+import os
+import logging
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, Dict, List, Optional
+
+logger = logging.getLogger(__name__)
+
+OVERLAP_POLICIES = ('skip', 'queue', 'cancel')
+
+
+class JobSpec:
+    def __init__(self, name: str, fn: Callable, lane: str = 'short', group: Optional[str] = None,
+                 overlap: str = 'skip', cancellable: bool = False):
+        # 環境変数 JOB_OVERLAP_<NAME> で重複ポリシーを上書き可能
+        overlap = os.getenv(f'JOB_OVERLAP_{name.upper()}', overlap)
+        if overlap not in OVERLAP_POLICIES:
+            raise ValueError(f"不正な重複ポリシー: {name}={overlap}")
+        self.name = name
+        self.fn = fn
+        self.lane = lane
+        self.group = group or name
+        self.overlap = overlap
+        self.cancellable = cancellable  # True なら fn(cancel_event) で呼び出す
+
+
+class _Run:
+    def __init__(self, spec: JobSpec):
+        self.spec = spec
+        self.cancel_event = threading.Event()
+
+
+class JobExecutor:
+    def __init__(self, lanes: Optional[Dict[str, int]] = None, group_limits: Optional[Dict[str, int]] = None):
+        lanes = lanes or {'long': int(os.getenv('LONG_JOB_WORKERS', '2')),
+                          'short': int(os.getenv('SHORT_JOB_WORKERS', '2'))}
+        self._pools = {lane: ThreadPoolExecutor(max_workers=workers, thread_name_prefix=f'job-{lane}')
+                       for lane, workers in lanes.items()}
+        self.group_limits = group_limits or {}
+        self.specs: Dict[str, JobSpec] = {}
+        self._running: Dict[str, List[_Run]] = {}
+        self._queued: Dict[str, List[JobSpec]] = {}
+        self._lock = threading.Lock()
+        self.stats = {'started': 0, 'skipped': 0, 'queued': 0, 'cancelled': 0, 'failed': 0}
+        self.on_finish: Optional[Callable[[], None]] = None  # ジョブ終了ごとの通知（シミュレーション用）
+
+    def register(self, spec: JobSpec):
+        if spec.lane not in self._pools:
+            raise ValueError(f"未定義のレーン: {spec.lane}")
+        self.specs[spec.name] = spec
+
+    def submit(self, name: str) -> bool:
+        """ジョブを投入（schedule から呼ばれ、すぐに戻る）→ 実行開始したか"""
+        spec = self.specs[name]
+        with self._lock:
+            running = self._running.setdefault(spec.group, [])
+            if len(running) < self.group_limits.get(spec.group, 1):
+                self._start(spec)
+                return True
+
+            if spec.overlap == 'skip':
+                self.stats['skipped'] += 1
+                logger.warning(f"ジョブをスキップ（{spec.group}実行中）: {name}")
+                return False
+
+            queued = self._queued.setdefault(spec.group, [])
+            if any(item.name == name for item in queued):
+                logger.info(f"ジョブは保留済みです: {name}")
+                return False
+            self.stats['queued'] += 1
+
+            if spec.overlap == 'cancel':
+                queued.insert(0, spec)  # 取消したジョブの次に実行
+                for run in running:
+                    if not run.cancel_event.is_set():
+                        run.cancel_event.set()
+                        self.stats['cancelled'] += 1
+                        logger.warning(f"実行中のジョブに取消を通知: {run.spec.name}（{name}を優先）")
+            else:
+                queued.append(spec)
+                logger.info(f"ジョブを保留（{spec.group}実行中）: {name}")
+            return False
+
+    def _start(self, spec: JobSpec):
+        # 呼び出し元で self._lock を保持していること
+        run = _Run(spec)
+        self._running[spec.group].append(run)
+        self.stats['started'] += 1
+        self._pools[spec.lane].submit(self._execute, run)
+
+    def _execute(self, run: _Run):
+        spec = run.spec
+        try:
+            if spec.cancellable:
+                spec.fn(run.cancel_event)
+            else:
+                spec.fn()
+        except Exception as e:
+            with self._lock:
+                self.stats['failed'] += 1
+            logger.error(f"ジョブ実行中にエラー: {spec.name} - {str(e)}")
+        finally:
+            with self._lock:
+                self._running[spec.group].remove(run)
+                queued = self._queued.get(spec.group)
+                if queued and len(self._running[spec.group]) < self.group_limits.get(spec.group, 1):
+                    self._start(queued.pop(0))
+            if self.on_finish:
+                self.on_finish()
+
+    def running(self) -> Dict[str, List[str]]:
+        with self._lock:
+            return {group: [run.spec.name for run in runs] for group, runs in self._running.items() if runs}
+
+    def busy(self) -> int:
+        with self._lock:
+            return sum(len(runs) for runs in self._running.values())
+
+    def shutdown(self, cancel: bool = True):
+        """停止（cancel=True なら実行中ジョブに取消を通知して終了を待つ）"""
+        with self._lock:
+            self._queued.clear()
+            if cancel:
+                for runs in self._running.values():
+                    for run in runs:
+                        run.cancel_event.set()
+        for pool in self._pools.values():
+            pool.shutdown(wait=True)
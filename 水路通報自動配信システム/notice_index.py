@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - 有効期間インデックス
+Author: WaterwaySystem
+Date: 2025-09-26
+
+構造化済みの通報（notice_parser.py）の有効期間を SQLite R*Tree に登録し、
+「日付Dに地域Rで有効な通報」を対数時間で取得する。
+
+- R*Tree の次元: (地域ID, 地域ID) × (開始日, 終了日)  ※日付は通日 (date.toordinal)
+- 取消通報は取込時に対象を解決し、対象の終了日を取消の前日に切り詰める
+- 取消が対象より先に取り込まれた場合も notice_cancellations に保留し、対象の取込時に適用
+"""
+
+import os
+import json
+import sqlite3
+import logging
+import argparse
+from datetime import date, datetime
+from typing import Dict, List, Optional
+
+import pytz
+
+import clock
+
+# 日本標準時の設定
+JST = pytz.timezone('Asia/Tokyo')
+
+logger = logging.getLogger(__name__)
+
+OPEN_END = date(9999, 12, 31).toordinal()
+
+
+class ValidityIndex:
+    def __init__(self, db_path: Optional[str] = None):
+        self.db_path = db_path or os.getenv('DB_PATH', './data/waterway_notices.db')
+
+    def connect(self) -> sqlite3.Connection:
+        conn = sqlite3.connect(self.db_path)
+        self.ensure_schema(conn)
+        return conn
+
+    @staticmethod
+    def ensure_schema(conn: sqlite3.Connection):
+        existing = {row[1] for row in conn.execute('PRAGMA table_info(waterway_notices)')}
+        if 'cancelled_by' not in existing:
+            conn.execute('ALTER TABLE waterway_notices ADD COLUMN cancelled_by INTEGER')
+        if 'indexed_at' not in existing:
+            conn.execute('ALTER TABLE waterway_notices ADD COLUMN indexed_at TIMESTAMP')
+        ValidityIndex._migrate_cancellations(conn)
+        conn.executescript('''
+            CREATE TABLE IF NOT EXISTS notice_regions (
+                region_id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT UNIQUE NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE IF NOT EXISTS notice_validity USING rtree(
+                id, region_min, region_max, start_day, end_day
+            );
+
+            CREATE TABLE IF NOT EXISTS notice_cancellations (
+                canceller_id INTEGER NOT NULL,
+                region TEXT NOT NULL,
+                target_year INTEGER,
+                target_seq INTEGER NOT NULL,
+                effective_day INTEGER NOT NULL,
+                target_id INTEGER,
+                PRIMARY KEY (canceller_id, target_year, target_seq)
+            );
+
+            CREATE INDEX IF NOT EXISTS idx_cancellations_target
+                ON notice_cancellations (region, target_seq, target_year);
+        ''')
+
+    @staticmethod
+    def _migrate_cancellations(conn: sqlite3.Connection):
+        """旧主キー (canceller_id, target_seq) の表を年込みの主キーへ作り直す"""
+        pk = {row[1]: row[5] for row in conn.execute('PRAGMA table_info(notice_cancellations)')}
+        if not pk or pk.get('target_year'):
+            return
+        conn.executescript('''
+            ALTER TABLE notice_cancellations RENAME TO notice_cancellations_old;
+            DROP INDEX IF EXISTS idx_cancellations_target;
+            CREATE TABLE notice_cancellations (
+                canceller_id INTEGER NOT NULL,
+                region TEXT NOT NULL,
+                target_year INTEGER,
+                target_seq INTEGER NOT NULL,
+                effective_day INTEGER NOT NULL,
+                target_id INTEGER,
+                PRIMARY KEY (canceller_id, target_year, target_seq)
+            );
+            INSERT INTO notice_cancellations SELECT
+                canceller_id, region, target_year, target_seq, effective_day, target_id
+            FROM notice_cancellations_old;
+            DROP TABLE notice_cancellations_old;
+        ''')
+        logger.info("notice_cancellations の主キーに対象年を追加しました")
+
+    def region_id(self, conn: sqlite3.Connection, name: str) -> int:
+        conn.execute('INSERT OR IGNORE INTO notice_regions (name) VALUES (?)', (name,))
+        return conn.execute('SELECT region_id FROM notice_regions WHERE name = ?', (name,)).fetchone()[0]
+
+    def index_pending(self) -> int:
+        """構造化済み・未登録の通報を登録（取込順に処理して取消を解決）"""
+        conn = self.connect()
+        try:
+            rows = conn.execute('''
+                SELECT id, region, notice_year, notice_seq, valid_from, valid_until,
+                       published_date, is_cancellation, cancels
+                FROM waterway_notices
+                WHERE parsed_at IS NOT NULL AND indexed_at IS NULL
+                ORDER BY id
+            ''').fetchall()
+            with conn:
+                for row in rows:
+                    self._index(conn, *row)
+            if rows:
+                logger.info(f"有効期間インデックス登録: {len(rows)}件")
+            return len(rows)
+        finally:
+            conn.close()
+
+    def _index(self, conn: sqlite3.Connection, notice_id: int, region: str, notice_year: Optional[int],
+               notice_seq: Optional[int], valid_from: Optional[str], valid_until: Optional[str],
+               published_date: Optional[str], is_cancellation: int, cancels: Optional[str]):
+        start_day = _day(valid_from) or _day(published_date) or clock.now(JST).date().toordinal()
+
+        if is_cancellation:
+            # 取消通報自体は有効期間を持たず、対象の期間を切り詰める
+            for entry in json.loads(cancels or '[]'):
+                # [年, 号]（旧形式は号のみ）。本文に年がなければ取消通報自身の年の通報とみなす
+                target_year, target_seq = entry if isinstance(entry, list) else (None, entry)
+                if target_year is None:
+                    target_year = notice_year
+                conn.execute('''
+                    INSERT OR REPLACE INTO notice_cancellations
+                        (canceller_id, region, target_year, target_seq, effective_day)
+                    VALUES (?, ?, ?, ?, ?)
+                ''', (notice_id, region, target_year, target_seq, start_day))
+                target = conn.execute('''
+                    SELECT id FROM waterway_notices
+                    WHERE region = ? AND notice_seq = ? AND (notice_year = ? OR ? IS NULL)
+                      AND is_cancellation = 0 AND cancelled_by IS NULL AND id < ?
+                    ORDER BY id DESC LIMIT 1
+                ''', (region, target_seq, target_year, target_year, notice_id)).fetchone()
+                if target:
+                    self._retire(conn, target[0], notice_id, target_year, target_seq, start_day)
+        else:
+            end_day = _day(valid_until) or OPEN_END
+            region_id = self.region_id(conn, region)
+            conn.execute('INSERT OR REPLACE INTO notice_validity VALUES (?, ?, ?, ?, ?)',
+                         (notice_id, region_id, region_id, start_day, max(start_day, end_day)))
+
+            # 先に取り込まれていた取消を適用
+            if notice_seq is not None:
+                pending = conn.execute('''
+                    SELECT canceller_id, target_year, effective_day FROM notice_cancellations
+                    WHERE region = ? AND target_seq = ? AND (target_year = ? OR target_year IS NULL OR ? IS NULL)
+                      AND target_id IS NULL
+                    ORDER BY canceller_id LIMIT 1
+                ''', (region, notice_seq, notice_year, notice_year)).fetchone()
+                if pending:
+                    self._retire(conn, notice_id, pending[0], pending[1], notice_seq, pending[2])
+
+        conn.execute('UPDATE waterway_notices SET indexed_at = CURRENT_TIMESTAMP WHERE id = ?', (notice_id,))
+
+    def _retire(self, conn: sqlite3.Connection, target_id: int, canceller_id: int,
+                target_year: Optional[int], target_seq: int, effective_day: int):
+        """取消の適用: 取消の効力発生日の前日で有効期間を終了"""
+        conn.execute('UPDATE waterway_notices SET cancelled_by = ? WHERE id = ?', (canceller_id, target_id))
+        conn.execute('''
+            UPDATE notice_cancellations SET target_id = ?
+            WHERE canceller_id = ? AND target_year IS ? AND target_seq = ?
+        ''', (target_id, canceller_id, target_year, target_seq))
+        row = conn.execute('SELECT start_day FROM notice_validity WHERE id = ?', (target_id,)).fetchone()
+        if row is None:
+            return
+        if effective_day <= row[0]:
+            conn.execute('DELETE FROM notice_validity WHERE id = ?', (target_id,))
+        else:
+            conn.execute('UPDATE notice_validity SET end_day = ? WHERE id = ?', (effective_day - 1, target_id))
+
+    def active(self, on: date, region: Optional[str] = None) -> List[Dict]:
+        """指定日に有効な通報（regionなしで全地域）"""
+        day = on.toordinal()
+        conn = self.connect()
+        conn.row_factory = sqlite3.Row
+        try:
+            if region is None:
+                region_min, region_max = float('-inf'), float('inf')
+            else:
+                row = conn.execute('SELECT region_id FROM notice_regions WHERE name = ?', (region,)).fetchone()
+                if row is None:
+                    return []
+                region_min = region_max = row[0]
+
+            rows = conn.execute('''
+                SELECT n.* FROM notice_validity v JOIN waterway_notices n ON n.id = v.id
+                WHERE v.start_day <= ? AND v.end_day >= ? AND v.region_max >= ? AND v.region_min <= ?
+                ORDER BY n.region, n.valid_from, n.id
+            ''', (day, day, region_min, region_max)).fetchall()
+            return [dict(row) for row in rows]
+        finally:
+            conn.close()
+
+    def rebuild(self) -> int:
+        """インデックスを破棄して全件再登録（再解析後などに使用）"""
+        conn = self.connect()
+        try:
+            with conn:
+                conn.execute('DELETE FROM notice_validity')
+                conn.execute('DELETE FROM notice_cancellations')
+                conn.execute('UPDATE waterway_notices SET indexed_at = NULL, cancelled_by = NULL')
+        finally:
+            conn.close()
+        return self.index_pending()
+
+
+def _day(value: Optional[str]) -> Optional[int]:
+    if not value:
+        return None
+    try:
+        return date.fromisoformat(value[:10]).toordinal()
+    except ValueError:
+        return None
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+
+    parser = argparse.ArgumentParser(description='水路通報 有効期間インデックス')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    subparsers.add_parser('index', help='未登録の通報を登録')
+    subparsers.add_parser('rebuild', help='インデックスを再構築')
+
+    active = subparsers.add_parser('active', help='指定日に有効な通報を表示')
+    active.add_argument('--date', help='対象日 YYYY-MM-DD（省略時は今日）')
+    active.add_argument('--region', help='地域（省略時は全地域）')
+
+    args = parser.parse_args()
+    index = ValidityIndex()
+
+    if args.command == 'index':
+        index.index_pending()
+    elif args.command == 'rebuild':
+        index.rebuild()
+    elif args.command == 'active':
+        on = date.fromisoformat(args.date) if args.date else datetime.now(JST).date()
+        notices = index.active(on, args.region)
+        for notice in notices:
+            print(f"[{notice['region']}] {notice['notice_number'] or '-'} {notice['title']} "
+                  f"({notice['valid_from'] or '-'} 〜 {notice['valid_until'] or '-'})")
+        print(f"{on.isoformat()} 有効: {len(notices)}件")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,302 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - 水路通報の構造化パーサー
+Author: WaterwaySystem
+Date: 2025-09-26
+
+取込時に1回だけ本文を走査し、通報番号・区域・有効期間・座標・発行官署・取消対象を
+型付きカラムとして保存する。以降の絞り込みはカラム比較で済み、各処理で正規表現を
+繰り返す必要がない。
+
+- 全角数字・記号はNFKC正規化で半角に統一
+- 日付: 令和/平成の和暦（元年含む）・西暦、終了日の年省略は開始日から補完
+- 座標: 度分 / 度分秒 / 34-12.5N 形式、北緯・東経の接頭辞またはN/S/E/W
+"""
+
+import os
+import re
+import sys
+import json
+import sqlite3
+import logging
+import argparse
+import unicodedata
+from datetime import date
+from typing import Dict, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+ERA_BASE = {'令和': 2018, '平成': 1988}
+
+# 全トークンを1本の正規表現にまとめ、finditerの1パスで処理する（マッチ順に状態遷移）
+_YEAR = r'(?:(?P<{p}era>令和|平成)\s*(?P<{p}ey>元|\d{{1,2}})\s*年|(?P<{p}y>\d{{4}})\s*年)'
+_DMS = (r'(?P<{p}deg>\d{{1,3}})\s*(?P<{p}sep>度|°|-)\s*(?:(?P<{p}min>\d{{1,2}}(?:\.\d+)?)\s*(?:分|′|\')?)?'
+        r'\s*(?:(?P<{p}sec>\d{{1,2}}(?:\.\d+)?)\s*(?:秒|″|")\s*)?')
+
+TOKEN_PATTERN = re.compile('|'.join([
+    # 通報番号（年付き: 令和6年第12号 / 2024年第12号）
+    r'(?P<number>' + _YEAR.format(p='n') + r'?\s*第\s*(?P<num>\d{1,5})\s*号)',
+    # 日付
+    r'(?P<date>' + _YEAR.format(p='d') + r'?\s*(?P<dm>\d{1,2})\s*月\s*(?P<dd>\d{1,2})\s*日)',
+    # 座標成分
+    r'(?P<coord>(?P<cpre>北緯|南緯|東経|西経)?\s*' + _DMS.format(p='c') + r'(?P<hemi>[NSEW](?![A-Za-z]))?)',
+    # 期間の区切り・終端
+    r'(?P<range>から|より|~|〜|至)',
+    r'(?P<until>まで)',
+    # 取消
+    r'(?P<cancel>取り?消し?)',
+    # 区域（行末までを先読みで取得し、同じ行の座標も引き続き走査する）
+    r'(?P<area>(?:区域|場所|海域|位置)\s*:\s*)(?=(?P<area_text>[^\n]+))',
+    # 発行官署
+    r'(?P<office>第[一二三四五六七八九十]+管区海上保安本部|[一-鿿ァ-ヶー]{1,8}海上保安(?:部|署))',
+]))
+
+
+class ParsedNotice:
+    """1件の水路通報から抽出した型付きフィールド"""
+
+    def __init__(self):
+        self.notice_year: Optional[int] = None
+        self.notice_seq: Optional[int] = None
+        self.area: Optional[str] = None
+        self.issuing_office: Optional[str] = None
+        self.valid_from: Optional[date] = None
+        self.valid_until: Optional[date] = None
+        self.coordinates: List[Tuple[float, float]] = []
+        self.is_cancellation = False
+        self.cancels: List[Tuple[Optional[int], int]] = []  # (年, 号)、年の記載がなければ None
+
+    @property
+    def notice_number(self) -> Optional[str]:
+        if self.notice_seq is None:
+            return None
+        return f"{self.notice_year}-{self.notice_seq}" if self.notice_year else str(self.notice_seq)
+
+    def bounds(self) -> Tuple[Optional[float], Optional[float], Optional[float], Optional[float]]:
+        if not self.coordinates:
+            return None, None, None, None
+        lats = [lat for lat, _ in self.coordinates]
+        lons = [lon for _, lon in self.coordinates]
+        return min(lats), max(lats), min(lons), max(lons)
+
+    def to_row(self) -> Dict:
+        lat_min, lat_max, lon_min, lon_max = self.bounds()
+        return {
+            'notice_number': self.notice_number,
+            'notice_year': self.notice_year,
+            'notice_seq': self.notice_seq,
+            'area': self.area,
+            'issuing_office': self.issuing_office,
+            'valid_from': self.valid_from.isoformat() if self.valid_from else None,
+            'valid_until': self.valid_until.isoformat() if self.valid_until else None,
+            'lat_min': lat_min,
+            'lat_max': lat_max,
+            'lon_min': lon_min,
+            'lon_max': lon_max,
+            'coordinates': json.dumps(self.coordinates) if self.coordinates else None,
+            'is_cancellation': 1 if self.is_cancellation else 0,
+            'cancels': json.dumps([[year, seq] for year, seq in self.cancels]) if self.cancels else None,
+        }
+
+
+def _year(era: Optional[str], era_year: Optional[str], year: Optional[str]) -> Optional[int]:
+    if era:
+        return ERA_BASE[era] + (1 if era_year == '元' else int(era_year))
+    return int(year) if year else None
+
+
+def _degrees(m: re.Match) -> float:
+    value = float(m.group('cdeg'))
+    if m.group('cmin'):
+        value += float(m.group('cmin')) / 60
+    if m.group('csec'):
+        value += float(m.group('csec')) / 3600
+    return value
+
+
+def parse_notice(title: str, content: str = '', published_year: Optional[int] = None) -> ParsedNotice:
+    """タイトルと本文を1パスで構造化（年の記載がない日付はpublished_yearで補完）"""
+    text = unicodedata.normalize('NFKC', f"{title}\n{content or ''}")
+    notice = ParsedNotice()
+
+    last_date = None          # 直前の日付トークン
+    range_open = False        # 「から」の後で終了日待ち
+    last_year = published_year
+    pending_lat = None        # 経度待ちの緯度
+    last_number_end = -1      # 直前の通報番号の終了位置（取消対象の判定用）
+    last_number = None        # 直前の通報番号 (年, 号)
+    cancel_armed = False
+
+    for m in TOKEN_PATTERN.finditer(text):
+        # 区域は先読みグループが最後に閉じるため lastgroup が area_text になる
+        kind = 'area' if m.lastgroup == 'area_text' else m.lastgroup
+
+        if kind == 'number':
+            seq = int(m.group('num'))
+            year = _year(m.group('nera'), m.group('ney'), m.group('ny'))
+            if notice.notice_seq is None:
+                notice.notice_seq = seq
+                notice.notice_year = year
+            elif cancel_armed:
+                notice.cancels.append((year, seq))
+                cancel_armed = False
+            last_number, last_number_end = (year, seq), m.end()
+
+        elif kind == 'date':
+            year = _year(m.group('dera'), m.group('dey'), m.group('dy'))
+            month, day = int(m.group('dm')), int(m.group('dd'))
+            if year is None:
+                year = last_year
+                # 「12月20日から1月5日まで」のように年をまたぐ終了日
+                if range_open and last_date and month < last_date.month:
+                    year = last_date.year + 1
+            if year is None:
+                continue
+            try:
+                value = date(year, month, day)
+            except ValueError:
+                continue
+            last_year = year
+            if range_open:
+                if notice.valid_until is None:
+                    notice.valid_until = value
+                range_open = False
+            last_date = value
+
+        elif kind == 'range':
+            if last_date is not None and notice.valid_from is None:
+                notice.valid_from = last_date
+                range_open = True
+
+        elif kind == 'until':
+            if last_date is not None and notice.valid_until is None:
+                notice.valid_until = last_date
+
+        elif kind == 'coord':
+            axis, value = _coordinate(m)
+            if axis is None:
+                continue
+            if axis == 'lat':
+                pending_lat = value
+            elif pending_lat is not None:
+                notice.coordinates.append((round(pending_lat, 6), round(value, 6)))
+                pending_lat = None
+
+        elif kind == 'cancel':
+            notice.is_cancellation = True
+            # 「第12号を取り消す」: 直前の番号、「取消 第12号」: 次の番号が対象
+            own_number = (notice.notice_year, notice.notice_seq)
+            if last_number is not None and last_number != own_number and m.start() - last_number_end <= 4:
+                if last_number not in notice.cancels:
+                    notice.cancels.append(last_number)
+            else:
+                cancel_armed = True
+
+        elif kind == 'area':
+            if notice.area is None:
+                notice.area = m.group('area_text').strip()
+
+        elif kind == 'office':
+            if notice.issuing_office is None:
+                notice.issuing_office = m.group('office')
+
+    # 終了日が開始日より前なら誤抽出とみなし終了日なし（無期限）扱い
+    if notice.valid_from and notice.valid_until and notice.valid_until < notice.valid_from:
+        notice.valid_until = None
+    return notice
+
+
+def _coordinate(m: re.Match) -> Tuple[Optional[str], float]:
+    prefix, hemi, sep = m.group('cpre'), m.group('hemi'), m.group('csep')
+    # 「3-5」のような数字列を座標と誤認しないよう、ハイフン区切りは方位付きのみ採用
+    if sep == '-' and not (prefix or hemi):
+        return None, 0.0
+    value = _degrees(m)
+    if prefix in ('北緯', '南緯') or hemi in ('N', 'S'):
+        return 'lat', -value if (prefix == '南緯' or hemi == 'S') else value
+    if prefix in ('東経', '西経') or hemi in ('E', 'W'):
+        return 'lon', -value if (prefix == '西経' or hemi == 'W') else value
+    # 方位なしの度分は「緯度 → 経度」の順、90度超は経度
+    return ('lon' if value > 90 else 'lat'), value
+
+
+# 構造化カラム（waterway_notices に追加）
+NOTICE_COLUMNS = {
+    'notice_number': 'TEXT',
+    'notice_year': 'INTEGER',
+    'notice_seq': 'INTEGER',
+    'area': 'TEXT',
+    'issuing_office': 'TEXT',
+    'valid_from': 'TEXT',
+    'valid_until': 'TEXT',
+    'lat_min': 'REAL',
+    'lat_max': 'REAL',
+    'lon_min': 'REAL',
+    'lon_max': 'REAL',
+    'coordinates': 'TEXT',
+    'is_cancellation': 'INTEGER DEFAULT 0',
+    'cancels': 'TEXT',
+    'parsed_at': 'TIMESTAMP',
+}
+
+
+def ensure_schema(conn: sqlite3.Connection):
+    """既存のwaterway_noticesに構造化カラムと索引を追加"""
+    existing = {row[1] for row in conn.execute('PRAGMA table_info(waterway_notices)')}
+    for column, column_type in NOTICE_COLUMNS.items():
+        if column not in existing:
+            conn.execute(f'ALTER TABLE waterway_notices ADD COLUMN {column} {column_type}')
+    conn.execute('CREATE INDEX IF NOT EXISTS idx_notices_number ON waterway_notices (notice_year, notice_seq)')
+    conn.execute('CREATE INDEX IF NOT EXISTS idx_notices_region_valid ON waterway_notices (region, valid_from, valid_until)')
+
+
+def store_parsed(conn: sqlite3.Connection, notice_id: int, parsed: ParsedNotice):
+    row = parsed.to_row()
+    assignments = ', '.join(f"{column} = ?" for column in row)
+    conn.execute(f'UPDATE waterway_notices SET {assignments}, parsed_at = CURRENT_TIMESTAMP WHERE id = ?',
+                 (*row.values(), notice_id))
+
+
+def ingest_pending(db_path: str, reparse: bool = False) -> int:
+    """未解析の通報を構造化（reparse=Trueで全件再解析）"""
+    conn = sqlite3.connect(db_path)
+    try:
+        with conn:
+            ensure_schema(conn)
+        where = '' if reparse else 'WHERE parsed_at IS NULL'
+        rows = conn.execute(f'SELECT id, title, content, published_date FROM waterway_notices {where} ORDER BY id').fetchall()
+        with conn:
+            for notice_id, title, content, published_date in rows:
+                published_year = int(published_date[:4]) if published_date and published_date[:4].isdigit() else None
+                store_parsed(conn, notice_id, parse_notice(title, content, published_year))
+        logger.info(f"水路通報構造化: {len(rows)}件")
+        return len(rows)
+    finally:
+        conn.close()
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+
+    parser = argparse.ArgumentParser(description='水路通報 構造化パーサー')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    ingest = subparsers.add_parser('ingest', help='未解析の通報を構造化')
+    ingest.add_argument('--reparse', action='store_true', help='解析済みも含めて再解析')
+
+    show = subparsers.add_parser('parse', help='標準入力の通報本文を解析して表示')
+    show.add_argument('--year', type=int, help='年の記載がない日付の補完年')
+
+    args = parser.parse_args()
+    db_path = os.getenv('DB_PATH', './data/waterway_notices.db')
+
+    if args.command == 'ingest':
+        ingest_pending(db_path, reparse=args.reparse)
+    elif args.command == 'parse':
+        text = sys.stdin.read()
+        print(json.dumps(parse_notice(text, '', args.year).to_row(), ensure_ascii=False, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -12,12 +12,17 @@ import time
 import logging
 import schedule
 import subprocess
-from datetime import datetime, timedelta
 from typing import Optional, Dict, Any
 import pytz
 import signal
+import threading
 import json
 from pathlib import Path
+from db_backup import DatabaseBackup
+from notice_parser import ingest_pending
+from notice_index import ValidityIndex
+from job_executor import JobExecutor, JobSpec
+import clock
 
 # 日本標準時の設定
 JST = pytz.timezone('Asia/Tokyo')
@@ -54,8 +59,15 @@ class WaterwayScheduler:
             'weekly_day': os.getenv('WEEKLY_SCHEDULE_DAY', 'friday'),
             'weekly_time': os.getenv('WEEKLY_SCHEDULE_TIME', '09:30'),
             'default_regions': os.getenv('DEFAULT_REGIONS', 'all'),
-            'max_retry': int(os.getenv('MAX_RETRY_COUNT', '3'))
+            'max_retry': int(os.getenv('MAX_RETRY_COUNT', '3')),
+            'backup_time': os.getenv('BACKUP_SCHEDULE_TIME', '03:00'),
+            'archive_interval': int(os.getenv('BACKUP_ARCHIVE_INTERVAL_MINUTES', '15')),
+            'memory_budget_mb': float(os.getenv('MEMORY_BUDGET_MB', '400')),
+            'memory_soft_limit_ratio': float(os.getenv('MEMORY_SOFT_LIMIT_RATIO', '0.8')),
+            'max_concurrent_requests': int(os.getenv('MAX_CONCURRENT_REQUESTS', '5'))
         }
+        # 子プロセスに渡す同時リクエスト数（前回の最大RSSがソフト上限を超えると半減、余裕があれば設定値まで戻す）
+        self.child_concurrency = self.config['max_concurrent_requests']
 
         self.logger.info(f"設定を読み込みました: {json.dumps(self.config, ensure_ascii=False, indent=2)}")
 
@@ -69,10 +81,11 @@ class WaterwayScheduler:
         self.logger.info(f"終了シグナル({signum})を受信しました。スケジューラーを停止します。")
         self.is_running = False
 
-    def run_waterway_system(self, job_type: str, regions: str = 'all', dry_run: Optional[bool] = None) -> bool:
+    def run_waterway_system(self, job_type: str, regions: str = 'all', dry_run: Optional[bool] = None,
+                            cancel_event: Optional[threading.Event] = None) -> bool:
         """水路通報システムの実行"""
         try:
-            current_time = datetime.now(JST)
+            current_time = clock.now(JST)
             self.logger.info(f"水路通報システム実行開始: {job_type} - {current_time.strftime('%Y-%m-%d %H:%M:%S JST')}")
 
             # dry_runパラメータの決定
@@ -94,43 +107,118 @@ class WaterwayScheduler:
             env.update({
                 'TZ': self.config['timezone'],
                 'PYTHONUNBUFFERED': '1',
-                'PYTHONPATH': '/app'
+                'PYTHONPATH': '/app',
+                'MAX_CONCURRENT_REQUESTS': str(self.child_concurrency)
             })
 
-            # コマンド実行
-            result = subprocess.run(
-                cmd,
-                capture_output=True,
-                text=True,
-                timeout=3600,  # 1時間でタイムアウト
-                env=env,
-                cwd='/app'
-            )
+            result = self.run_child(cmd, env, job_type, cancel_event)
+            if result is None:
+                return False
+
+            self.check_child_memory(job_type, getattr(result, 'peak_rss_mb', None))
 
             if result.returncode == 0:
                 self.logger.info(f"水路通報システム実行成功: {job_type}")
                 if result.stdout:
                     self.logger.info(f"実行結果: {result.stdout}")
+                self.structure_notices()
                 return True
             else:
                 self.logger.error(f"水路通報システム実行失敗: {job_type}")
                 self.logger.error(f"エラー出力: {result.stderr}")
                 return False
-
-        except subprocess.TimeoutExpired:
-            self.logger.error(f"水路通報システム実行タイムアウト: {job_type}")
-            return False
         except Exception as e:
             self.logger.error(f"水路通報システム実行中にエラー: {job_type} - {str(e)}")
             return False
 
-    def daily_job(self):
+    def run_child(self, cmd: list, env: Dict[str, str], job_type: str,
+                  cancel_event: Optional[threading.Event] = None) -> Optional[subprocess.CompletedProcess]:
+        """子プロセス実行（取消通知・タイムアウト時は停止して None）
+
+        実行中に /proc/<pid>/status の VmHWM（その子プロセス自身の最大RSS）を読み、結果の peak_rss_mb に設定する。
+        """
+        process = subprocess.Popen(
+            cmd,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            text=True,
+            env=env,
+            cwd='/app'
+        )
+        deadline = time.monotonic() + 3600  # 1時間でタイムアウト
+        peak_rss_mb = None
+        while True:
+            try:
+                stdout, stderr = process.communicate(timeout=1)
+                result = subprocess.CompletedProcess(cmd, process.returncode, stdout, stderr)
+                result.peak_rss_mb = peak_rss_mb
+                return result
+            except subprocess.TimeoutExpired:
+                # VmHWM は単調増加なので、終了前に読めた最新値がこの子プロセスの最大値
+                peak_rss_mb = self.read_peak_rss_mb(process.pid) or peak_rss_mb
+                cancelled = cancel_event is not None and cancel_event.is_set()
+                if cancelled or time.monotonic() >= deadline:
+                    self.stop_child(process)
+                    self.logger.error(f"水路通報システム実行{'取消' if cancelled else 'タイムアウト'}: {job_type}")
+                    return None
+
+    def stop_child(self, process: subprocess.Popen):
+        """子プロセス停止（SIGTERM後、応答がなければSIGKILL）"""
+        process.terminate()
+        try:
+            process.communicate(timeout=30)
+        except subprocess.TimeoutExpired:
+            process.kill()
+            process.communicate()
+
+    def structure_notices(self):
+        """新規取込分の通報を構造化し、有効期間インデックスに登録（失敗しても配信結果には影響させない）"""
+        try:
+            db_path = os.getenv('DB_PATH', './data/waterway_notices.db')
+            ingest_pending(db_path)
+            ValidityIndex(db_path).index_pending()
+        except Exception as e:
+            self.logger.error(f"水路通報構造化中にエラー: {str(e)}")
+
+    @staticmethod
+    def read_peak_rss_mb(pid: int) -> Optional[float]:
+        """子プロセスの最大RSS（VmHWM、kB表記）。終了済み・/proc がない環境では None"""
+        try:
+            with open(f'/proc/{pid}/status', 'r') as f:
+                for line in f:
+                    if line.startswith('VmHWM:'):
+                        return int(line.split()[1]) / 1024
+        except (OSError, ValueError, IndexError):
+            pass
+        return None
+
+    def check_child_memory(self, job_type: str, peak_rss_mb: Optional[float]):
+        """今回の子プロセスの最大RSSをメモリ予算と比較し、次回の同時リクエスト数を調整"""
+        # RUSAGE_CHILDREN は過去の全子プロセス中の最大値なので使わない（1回重い実行があると以降すべて警告になる）
+        if peak_rss_mb is None:
+            self.logger.info(f"子プロセス最大RSS: {job_type} - 計測なし（1秒未満で終了、または /proc なし）")
+            return
+        budget_mb = self.config['memory_budget_mb']
+
+        soft_limit_mb = budget_mb * self.config['memory_soft_limit_ratio']
+
+        self.logger.info(f"子プロセス最大RSS: {job_type} - {peak_rss_mb:.1f}MB / 予算 {budget_mb:.0f}MB")
+        if peak_rss_mb >= soft_limit_mb:
+            self.child_concurrency = max(1, self.child_concurrency // 2)
+            self.logger.warning(f"子プロセスのメモリ使用量がコンテナ制限に近づいています: {peak_rss_mb:.1f}MB "
+                                f"(次回の同時リクエスト数 {self.child_concurrency})")
+        elif peak_rss_mb < soft_limit_mb / 2 and self.child_concurrency < self.config['max_concurrent_requests']:
+            self.child_concurrency = min(self.config['max_concurrent_requests'], self.child_concurrency * 2)
+            self.logger.info(f"メモリに余裕があるため同時リクエスト数を戻します: {self.child_concurrency}")
+
+    def daily_job(self, cancel_event: Optional[threading.Event] = None):
         """日次ジョブの実行"""
         self.logger.info("日次ジョブを開始します")
 
         success = self.run_waterway_system(
             job_type='daily',
-            regions=self.config['default_regions']
+            regions=self.config['default_regions'],
+            cancel_event=cancel_event
         )
 
         if success:
@@ -140,13 +228,14 @@ class WaterwayScheduler:
 
         self.log_execution_status('daily', success)
 
-    def weekly_job(self):
+    def weekly_job(self, cancel_event: Optional[threading.Event] = None):
         """週次ジョブの実行"""
         self.logger.info("週次まとめジョブを開始します")
 
         success = self.run_waterway_system(
             job_type='weekly',
-            regions=self.config['default_regions']
+            regions=self.config['default_regions'],
+            cancel_event=cancel_event
         )
 
         if success:
@@ -156,10 +245,22 @@ class WaterwayScheduler:
 
         self.log_execution_status('weekly', success)
 
+    def backup_job(self):
+        """ベースバックアップジョブの実行"""
+        self.logger.info("データベースバックアップを開始します")
+
+        success = DatabaseBackup().run_backup() is not None
+
+        self.log_execution_status('backup', success)
+
+    def archive_job(self):
+        """差分アーカイブジョブの実行"""
+        DatabaseBackup().run_archive()
+
     def health_check(self):
         """システムヘルスチェック"""
         try:
-            current_time = datetime.now(JST)
+            current_time = clock.now(JST)
 
             # ディスク容量チェック
             disk_usage = self.check_disk_usage()
@@ -241,7 +342,7 @@ class WaterwayScheduler:
 
             # 新しい実行情報を追加
             execution_info = {
-                'timestamp': datetime.now(JST).isoformat(),
+                'timestamp': clock.now(JST).isoformat(),
                 'job_type': job_type,
                 'success': success,
                 'dry_run': self.config['dry_run']
@@ -259,23 +360,45 @@ class WaterwayScheduler:
         except Exception as e:
             self.logger.error(f"実行状況ログ記録エラー: {str(e)}")
 
+    def setup_executor(self):
+        """ジョブ実行器の設定（scheduleはジョブを投入するだけで、実行はワーカーで行う）"""
+        self.executor = JobExecutor()
+        # 配信（日次・週次）は同じDBに書き込むため同一グループで1件ずつ
+        self.executor.register(JobSpec('daily', self.daily_job, lane='long', group='delivery',
+                                       overlap='queue', cancellable=True))
+        self.executor.register(JobSpec('weekly', self.weekly_job, lane='long', group='delivery',
+                                       overlap='queue', cancellable=True))
+        # ベースバックアップ中の差分アーカイブは不要なのでスキップ
+        self.executor.register(JobSpec('backup', self.backup_job, lane='long', group='backup', overlap='skip'))
+        self.executor.register(JobSpec('archive', self.archive_job, lane='short', group='backup', overlap='skip'))
+        self.executor.register(JobSpec('health', self.health_check, lane='short', overlap='skip'))
+
     def setup_schedule(self):
         """スケジュールの設定"""
+        self.setup_executor()
+        submit = self.executor.submit
+
         # 日次ジョブ: 毎日06:30 JST
-        schedule.every().day.at(self.config['daily_time']).do(self.daily_job).tag('daily')
+        schedule.every().day.at(self.config['daily_time']).do(submit, 'daily').tag('daily')
 
         # 週次ジョブ: 毎週金曜09:30 JST
-        getattr(schedule.every(), self.config['weekly_day'].lower()).at(self.config['weekly_time']).do(self.weekly_job).tag('weekly')
+        getattr(schedule.every(), self.config['weekly_day'].lower()).at(self.config['weekly_time']).do(submit, 'weekly').tag('weekly')
 
         # ヘルスチェック: 毎時間
-        schedule.every().hour.do(self.health_check).tag('health')
+        schedule.every().hour.do(submit, 'health').tag('health')
+
+        # バックアップ: 毎日03:00 JSTにベース、以降は一定間隔で差分アーカイブ
+        schedule.every().day.at(self.config['backup_time']).do(submit, 'backup').tag('backup')
+        schedule.every(self.config['archive_interval']).minutes.do(submit, 'archive').tag('backup')
 
         # スケジュール情報をログ出力
         self.logger.info("スケジュール設定完了:")
         self.logger.info(f"  - 日次ジョブ: 毎日 {self.config['daily_time']} JST")
         self.logger.info(f"  - 週次ジョブ: 毎週{self.config['weekly_day']} {self.config['weekly_time']} JST")
         self.logger.info(f"  - ヘルスチェック: 毎時間")
+        self.logger.info(f"  - バックアップ: 毎日 {self.config['backup_time']} JST (差分: {self.config['archive_interval']}分毎)")
         self.logger.info(f"  - DRY_RUNモード: {'有効' if self.config['dry_run'] else '無効'}")
+        self.logger.info("  - ジョブ重複時: " + ', '.join(f"{spec.name}={spec.overlap}" for spec in self.executor.specs.values()))
 
     def run_scheduler(self):
         """スケジューラーのメイン実行"""
@@ -293,6 +416,8 @@ class WaterwayScheduler:
         except Exception as e:
             self.logger.error(f"スケジューラー実行中にエラー: {str(e)}")
         finally:
+            # 実行中ジョブに取消を通知し、終了を待ってから停止
+            self.executor.shutdown(cancel=True)
             self.logger.info("水路通報自動配信スケジューラーが終了しました")
 
     def run_manual_job(self, job_type: str, regions: str = 'all', dry_run: bool = True):
@@ -335,19 +460,24 @@ def main():
             # ヘルスチェックを実行
             scheduler.health_check()
 
+        elif command == 'backup':
+            # ベースバックアップを即座に実行
+            scheduler.backup_job()
+
         elif command == 'test':
             # テスト実行
             scheduler.run_manual_job('daily', 'tokyo', dry_run=True)
 
         else:
             print("使用方法:")
-            print("  python scheduler.py [scheduler|daily|weekly|health|test] [region] [--dry-run]")
+            print("  python scheduler.py [scheduler|daily|weekly|health|backup|test] [region] [--dry-run]")
             print("")
             print("コマンド:")
             print("  scheduler  : スケジューラーを開始（デフォルト）")
             print("  daily      : 日次ジョブを即座に実行")
             print("  weekly     : 週次ジョブを即座に実行")
             print("  health     : ヘルスチェックを実行")
+            print("  backup     : データベースバックアップを即座に実行")
             print("  test       : テスト実行（東京地域、dry-run）")
             print("")
             print("地域:")
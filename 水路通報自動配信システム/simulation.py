@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+水路通報自動配信システム - 仮想時計によるスケジュールシミュレーション
+Author: WaterwaySystem
+Date: 2025-09-26
+
+WaterwayScheduler のスケジュール（日次・週次・バックアップ・差分アーカイブ・ヘルスチェック）を
+仮想時計で早送りし、重複ポリシー・週次実行・停止後の追いつき実行を実時間を待たずに確認する。
+- 配信本体（waterway_notice_system.py）の子プロセスは、フィクスチャの通報を
+  仮想時刻に合わせてDBへ投入する模擬実行に置き換える（所要時間・失敗率を指定可能）
+- 通報の構造化・インデックス登録・バックアップは実際に実行し、1回あたりのCPU時間を集計
+- DB・バックアップは出力ディレクトリ配下を使用（本番データには触れない）
+
+使用例:
+    python simulation.py --days 365 --fixtures notices.json --output ./sim
+    python simulation.py --days 14 --job-minutes daily=90 --outage 2025-10-03T05:00+8
+    python simulation.py --days 365 --noop backup,archive   # スケジュール処理だけの負荷確認
+"""
+
+import os
+import json
+import time
+import random
+import logging
+import argparse
+import sqlite3
+import subprocess
+import threading
+from datetime import datetime, timedelta
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+import pytz
+import schedule
+
+import clock
+from clock import VirtualClock
+from job_executor import JobExecutor
+
+JST = pytz.timezone('Asia/Tokyo')
+
+logger = logging.getLogger(__name__)
+
+TICK_SECONDS = 0.001
+
+
+def parse_outage(text: str) -> Tuple[float, float]:
+    """'2025-10-03T05:00+8' → (開始, 終了) スケジューラー停止区間（時間単位）"""
+    start, hours = text.rsplit('+', 1)
+    begin = JST.localize(datetime.fromisoformat(start))
+    return begin.timestamp(), (begin + timedelta(hours=float(hours))).timestamp()
+
+
+class JobCosts:
+    """ジョブごとの実行回数・CPU時間・仮想所要時間"""
+
+    def __init__(self, sim_clock: VirtualClock):
+        self.clock = sim_clock
+        self.runs: Dict[str, List[Tuple[float, float, float]]] = {}  # (開始仮想時刻, CPU秒, 仮想秒)
+        self._lock = threading.Lock()
+
+    def wrap(self, executor: JobExecutor):
+        for spec in executor.specs.values():
+            spec.fn = self._measured(spec.name, spec.fn)
+
+    def _measured(self, name: str, fn):
+        def run(*args):
+            started, cpu = self.clock.time(), time.thread_time()
+            try:
+                return fn(*args)
+            finally:
+                with self._lock:
+                    self.runs.setdefault(name, []).append(
+                        (started, time.thread_time() - cpu, self.clock.time() - started))
+        return run
+
+    def summary(self) -> Dict[str, Dict]:
+        result = {}
+        for name, runs in sorted(self.runs.items()):
+            cpu_ms = sorted(run[1] * 1000 for run in runs)
+            result[name] = {
+                'runs': len(runs),
+                'cpu_ms_mean': round(sum(cpu_ms) / len(cpu_ms), 2),
+                'cpu_ms_p95': round(cpu_ms[min(len(cpu_ms) - 1, int(len(cpu_ms) * 0.95))], 2),
+                'cpu_ms_max': round(cpu_ms[-1], 2),
+                'virtual_minutes_mean': round(sum(run[2] for run in runs) / len(runs) / 60, 1),
+                'first_runs': [datetime.fromtimestamp(run[0], JST).strftime('%Y-%m-%d %a %H:%M')
+                               for run in runs[:3]],
+            }
+        return result
+
+
+class SimulatedChild:
+    """waterway_notice_system.py の代わりに、公開済みのフィクスチャ通報をDBへ投入する"""
+
+    def __init__(self, sim_clock: VirtualClock, db_path: str, fixtures: List[Dict], start: datetime,
+                 minutes: Dict[str, float], fail_rate: float, seed: int):
+        self.clock = sim_clock
+        self.db_path = db_path
+        self.minutes = minutes
+        self.fail_rate = fail_rate
+        self.rng = random.Random(seed)
+        self.failures = 0
+        self.pending = sorted(
+            (JST.localize(datetime.fromisoformat(item['published_date'])).timestamp()
+             if 'published_date' in item else (start + timedelta(days=item.get('offset_days', 0))).timestamp(),
+             item) for item in fixtures)
+        self.delivered = 0
+        self._lock = threading.Lock()
+
+        conn = sqlite3.connect(db_path)
+        with conn:
+            conn.execute('''
+                CREATE TABLE IF NOT EXISTS waterway_notices (
+                    id INTEGER PRIMARY KEY AUTOINCREMENT,
+                    region TEXT NOT NULL,
+                    title TEXT NOT NULL,
+                    content TEXT,
+                    published_date TEXT,
+                    url TEXT,
+                    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+                )
+            ''')
+            conn.execute('''
+                CREATE TABLE IF NOT EXISTS delivery_logs (
+                    id INTEGER PRIMARY KEY AUTOINCREMENT,
+                    region TEXT NOT NULL,
+                    delivery_type TEXT NOT NULL,
+                    status TEXT NOT NULL,
+                    message TEXT,
+                    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+                )
+            ''')
+        conn.close()
+
+    def __call__(self, cmd: list, env: Dict[str, str], job_type: str,
+                 cancel_event: Optional[threading.Event] = None) -> Optional[subprocess.CompletedProcess]:
+        # 所要時間は仮想時計上で1分ずつ消費し、その間の取消通知に応じる
+        for _ in range(int(self.minutes.get(job_type, 5))):
+            if cancel_event is not None and cancel_event.is_set():
+                return None
+            self.clock.sleep(60)
+
+        if self.rng.random() < self.fail_rate:
+            with self._lock:
+                self.failures += 1
+            return subprocess.CompletedProcess(cmd, 1, '', 'simulated failure')
+
+        now = self.clock.time()
+        with self._lock:
+            due = [item for published, item in self.pending if published <= now]
+            self.pending = [(published, item) for published, item in self.pending if published > now]
+            self.delivered += len(due)
+
+        conn = sqlite3.connect(self.db_path)
+        with conn:
+            conn.executemany('''
+                INSERT INTO waterway_notices (region, title, content, published_date, url)
+                VALUES (?, ?, ?, ?, ?)
+            ''', [(item.get('region', 'tokyo'), item['title'], item.get('content', ''),
+                   item.get('published_date') or clock.now(JST).strftime('%Y-%m-%d %H:%M:%S'),
+                   item.get('url')) for item in due])
+            conn.execute('INSERT INTO delivery_logs (region, delivery_type, status, message) VALUES (?, ?, ?, ?)',
+                         ('all', job_type, 'simulated', f"{len(due)}件"))
+        conn.close()
+        return subprocess.CompletedProcess(cmd, 0, f"simulated {job_type}: {len(due)}件", '')
+
+
+def drive(sim_clock: VirtualClock, executor: JobExecutor, until: float,
+          outages: List[Tuple[float, float]]) -> int:
+    """次のイベント時刻へ順に時計を進めて run_pending() → 処理したイベント数"""
+    events = 0
+    while True:
+        # 実行中のジョブが全て仮想 sleep 中（または終了）になってから進める
+        if not sim_clock.wait_quiescent(executor.busy):
+            logger.error("シミュレーション停止: ジョブが仮想時計外で待機しています")
+            break
+        next_run = schedule.next_run()
+        # 実運用と同様に予定時刻の直後に run_pending() する
+        # （ちょうど予定時刻だと schedule が週次の次回実行を同じ時刻に再計算してしまう）
+        scheduled = next_run.timestamp() + TICK_SECONDS if next_run else None
+        for begin, end in outages:
+            if scheduled is not None and begin <= scheduled < end:
+                scheduled = end  # 停止中は run_pending() しない（再開時に追いつき実行）
+        candidates = [t for t in (scheduled, sim_clock.next_wake()) if t is not None]
+        if not candidates or min(candidates) > until:
+            break
+        target = min(candidates)
+        sim_clock.advance_to(target)
+        if not any(begin <= target < end for begin, end in outages):
+            schedule.run_pending()
+        events += 1
+
+    # 新規投入を止め、実行中のジョブを最後まで進める
+    schedule.clear()
+    while executor.busy():
+        sim_clock.wait_quiescent(executor.busy)
+        wake = sim_clock.next_wake()
+        if wake is None:
+            break
+        sim_clock.advance_to(wake)
+    return events
+
+
+def run_simulation(days: float, start: Optional[datetime] = None, fixtures: Optional[List[Dict]] = None,
+                   output_dir: str = './sim', job_minutes: Optional[Dict[str, float]] = None,
+                   fail_rate: float = 0.0, seed: int = 0,
+                   outages: Optional[List[Tuple[float, float]]] = None,
+                   noop_jobs: Optional[List[str]] = None) -> Dict:
+    output = Path(output_dir)
+    output.mkdir(parents=True, exist_ok=True)
+    os.environ['TZ'] = 'Asia/Tokyo'
+    time.tzset()
+    os.environ['DB_PATH'] = str(output / 'waterway_notices.db')
+    os.environ['BACKUP_PATH'] = str(output / 'backups')
+    os.environ['BACKUP_STEP_PAUSE'] = '0'
+
+    if start is None:
+        start = JST.localize(datetime.combine(datetime.now(JST).date() + timedelta(days=1), datetime.min.time()))
+    sim_clock = VirtualClock(start)
+    clock.install(sim_clock)
+
+    from scheduler import WaterwayScheduler
+    schedule.clear()
+    scheduler = WaterwayScheduler()
+    child = SimulatedChild(sim_clock, os.environ['DB_PATH'], fixtures or [], start,
+                           job_minutes or {'daily': 10, 'weekly': 30}, fail_rate, seed)
+    scheduler.run_child = child
+    scheduler.setup_schedule()
+    for name in noop_jobs or []:
+        # スケジュール・重複判定だけを見たいジョブは中身を空にする（バックアップのI/Oなど）
+        scheduler.executor.specs[name].fn = lambda *args: None
+    costs = JobCosts(sim_clock)
+    costs.wrap(scheduler.executor)
+    scheduler.executor.on_finish = sim_clock.notify
+
+    real_started = time.perf_counter()
+    try:
+        events = drive(sim_clock, scheduler.executor, start.timestamp() + days * 86400, outages or [])
+    finally:
+        scheduler.executor.shutdown(cancel=True)
+        clock.install(clock.SystemClock())
+
+    report = {
+        'start': start.isoformat(),
+        'end': sim_clock.now(JST).isoformat(),
+        'simulated_days': days,
+        'real_seconds': round(time.perf_counter() - real_started, 2),
+        'events': events,
+        'jobs': costs.summary(),
+        'executor': dict(scheduler.executor.stats),
+        'notices_delivered': child.delivered,
+        'simulated_failures': child.failures,
+    }
+    with open(output / 'report.json', 'w', encoding='utf-8') as f:
+        json.dump(report, f, ensure_ascii=False, indent=2)
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description='水路通報 スケジュールシミュレーション（仮想時計）')
+    parser.add_argument('--days', type=float, default=28, help='シミュレーション日数')
+    parser.add_argument('--start', help='開始日時 JST（例: 2025-10-01T00:00、既定: 翌日0時）')
+    parser.add_argument('--fixtures', help='通報フィクスチャ JSON（published_date または offset_days を持つ配列）')
+    parser.add_argument('--output', default='./sim', help='DB・バックアップ・レポートの出力先')
+    parser.add_argument('--job-minutes', default='daily=10,weekly=30', help='配信ジョブの仮想所要時間（分）')
+    parser.add_argument('--fail-rate', type=float, default=0.0, help='配信ジョブの失敗率 (0.0-1.0)')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--outage', action='append', default=[], help='スケジューラー停止区間（例: 2025-10-03T05:00+8）')
+    parser.add_argument('--noop', default='', help='中身を実行しないジョブ（例: backup,archive）')
+    args = parser.parse_args()
+
+    os.environ.setdefault('LOG_LEVEL', 'WARNING')
+    fixtures = None
+    if args.fixtures:
+        with open(args.fixtures, 'r', encoding='utf-8') as f:
+            fixtures = json.load(f)
+    start = JST.localize(datetime.fromisoformat(args.start)) if args.start else None
+    job_minutes = {key: float(value) for key, value in
+                   (item.split('=', 1) for item in args.job_minutes.split(',') if item)}
+
+    report = run_simulation(args.days, start, fixtures, args.output, job_minutes,
+                            args.fail_rate, args.seed, [parse_outage(text) for text in args.outage],
+                            [name for name in args.noop.split(',') if name])
+    print(json.dumps(report, ensure_ascii=False, indent=2))
+
+
+if __name__ == "__main__":
+    main()
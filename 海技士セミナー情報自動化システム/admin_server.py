@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 관리용 HTTP 서버
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import hmac
+import json
+import logging
+import threading
+from http.server import ThreadingHTTPServer, BaseHTTPRequestHandler
+from urllib.parse import urlparse, parse_qs
+from typing import Callable, Dict, Tuple
+
+logger = logging.getLogger(__name__)
+
+# 핸들러: (query, headers) -> (status, content_type, body[, extra headers])
+RouteHandler = Callable[[Dict, Dict], Tuple]
+
+
+class AdminServer:
+    """스케줄러 프로세스 내부에서 동작하는 관리용 엔드포인트"""
+
+    def __init__(self, host: str = None, port: int = None):
+        # 기본은 로컬 전용 (외부 공개 시 ADMIN_HOST=0.0.0.0 + ADMIN_TOKEN 으로 보호 경로에 인증 요구)
+        self.host = host or os.getenv('ADMIN_HOST', '127.0.0.1')
+        self.port = port if port is not None else int(os.getenv('ADMIN_PORT', '8080'))
+        self.token = os.getenv('ADMIN_TOKEN', '')
+        self.routes: Dict[str, RouteHandler] = {}
+        self.prefix_routes: Dict[str, RouteHandler] = {}
+        self.protected = set()
+        self._server = None
+        self._thread = None
+        self.add_route('/health', lambda query, headers: (200, 'application/json', {'status': 'ok'}))
+
+    def add_route(self, path: str, handler: RouteHandler, prefix: bool = False, protected: bool = False):
+        """경로 등록 (prefix=True면 하위 경로 전체를 처리, protected=True면 ADMIN_TOKEN 설정 시 Bearer 인증 필요)"""
+        if protected:
+            self.protected.add(path)
+        if prefix:
+            self.prefix_routes[path] = handler
+        else:
+            self.routes[path] = handler
+
+    def resolve(self, path: str):
+        handler = self.routes.get(path)
+        if handler:
+            return handler
+        for prefix, handler in self.prefix_routes.items():
+            if path.startswith(prefix):
+                return handler
+        return None
+
+    def authorized(self, path: str, headers: Dict) -> bool:
+        if not self.token or path not in self.protected:
+            return True
+        supplied = headers.get('Authorization', '')
+        return hmac.compare_digest(supplied.encode('utf-8'), f"Bearer {self.token}".encode('utf-8'))
+
+    def start(self):
+        server = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                parsed = urlparse(self.path)
+                handler = server.resolve(parsed.path)
+                if handler is None:
+                    self._send(404, 'application/json', {'error': 'not found'})
+                    return
+                if not server.authorized(parsed.path, self.headers):
+                    self._send(401, 'application/json', {'error': 'unauthorized'}, {'WWW-Authenticate': 'Bearer'})
+                    return
+                query = {k: v[-1] for k, v in parse_qs(parsed.query).items()}
+                query['_path'] = parsed.path
+                try:
+                    self._send(*handler(query, dict(self.headers)))
+                except Exception as e:
+                    logger.error(f"管理エンドポイントエラー ({parsed.path}): {str(e)}")
+                    self._send(500, 'application/json', {'error': str(e)})
+
+            def _send(self, status: int, content_type: str, body, extra_headers: Dict = None):
+                if isinstance(body, (dict, list)):
+                    body = json.dumps(body, ensure_ascii=False, default=str)
+                payload = body.encode('utf-8') if isinstance(body, str) else (body or b'')
+                self.send_response(status)
+                self.send_header('Content-Type', f"{content_type}; charset=utf-8")
+                self.send_header('Content-Length', str(len(payload)))
+                for key, value in (extra_headers or {}).items():
+                    self.send_header(key, value)
+                self.end_headers()
+                if self.command != 'HEAD':
+                    self.wfile.write(payload)
+
+            def log_message(self, format, *args):
+                logger.debug(f"管理サーバー: {format % args}")
+
+        self._server = ThreadingHTTPServer((self.host, self.port), Handler)
+        self._server.daemon_threads = True
+        self._thread = threading.Thread(target=self._server.serve_forever, name='admin-server', daemon=True)
+        self._thread.start()
+        logger.info(f"管理サーバー開始: http://{self.host}:{self.port}")
+
+    def stop(self):
+        if self._server:
+            self._server.shutdown()
+            self._server.server_close()
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 교체 가능한 시계
+Author: Manus AI
+Date: 2025-09-26
+
+스케줄에 관련된 현재 시각・대기는 이 모듈을 통해 얻는다.
+평소에는 실시간(SystemClock), 시뮬레이션에서는 VirtualClock 으로 교체해
+수 주~1년 분량의 스케줄을 몇 초 만에 진행한다.
+
+VirtualClock 은 이산 이벤트 방식:
+- sleep() 은 가상 시각이 기상 시각에 도달할 때까지 블록 (스스로 시계를 진행하지 않음)
+- 시뮬레이션 구동 측이 실행 중인 작업이 모두 sleep 중이거나 종료된 것을 확인한 뒤
+  다음 이벤트(스케줄의 다음 실행 또는 가장 이른 기상 시각)까지 시계를 진행
+"""
+
+import time as _time
+import threading
+import datetime as _datetime
+from datetime import datetime, tzinfo
+from typing import Callable, List, Optional
+
+
+class SystemClock:
+    """실시간"""
+
+    def now(self, tz: Optional[tzinfo] = None) -> datetime:
+        return datetime.now(tz)
+
+    def time(self) -> float:
+        return _time.time()
+
+    def sleep(self, seconds: float):
+        _time.sleep(seconds)
+
+
+class VirtualClock(SystemClock):
+    """가상 시각 (구동 측이 advance_to() 로 진행)"""
+
+    def __init__(self, start: datetime):
+        self._t = start.timestamp()
+        self._sleepers: List[float] = []  # 기상 대기 시각
+        self._cond = threading.Condition()
+
+    def now(self, tz: Optional[tzinfo] = None) -> datetime:
+        # tz=None 은 프로세스의 로컬 시각 (schedule 라이브러리와 동일)
+        return datetime.fromtimestamp(self.time(), tz)
+
+    def time(self) -> float:
+        with self._cond:
+            return self._t
+
+    def sleep(self, seconds: float):
+        with self._cond:
+            if seconds <= 0:
+                return
+            wake_at = self._t + seconds
+            self._sleepers.append(wake_at)
+            self._cond.notify_all()
+            while self._t < wake_at:
+                self._cond.wait()
+
+    def sleeping(self) -> int:
+        with self._cond:
+            return len(self._sleepers)
+
+    def next_wake(self) -> Optional[float]:
+        with self._cond:
+            return min(self._sleepers) if self._sleepers else None
+
+    def advance_to(self, timestamp: float):
+        """시계를 진행하고 기상 시각에 도달한 sleep 해제"""
+        with self._cond:
+            if timestamp > self._t:
+                self._t = timestamp
+            self._sleepers = [wake_at for wake_at in self._sleepers if wake_at > self._t]
+            self._cond.notify_all()
+
+    def notify(self):
+        """작업 종료를 구동 측에 통지"""
+        with self._cond:
+            self._cond.notify_all()
+
+    def wait_quiescent(self, busy: Callable[[], int], timeout: float = 300.0) -> bool:
+        """실행 중 작업 수 busy() 가 모두 sleep 중이 될 때까지 (실시간으로) 대기"""
+        deadline = _time.monotonic() + timeout
+        with self._cond:
+            while len(self._sleepers) < busy():
+                remaining = deadline - _time.monotonic()
+                if remaining <= 0:
+                    return False
+                # sleep() 시작과 작업 종료(notify())로 깨어남. 누락에 대비해 주기적으로도 재확인
+                self._cond.wait(min(remaining, 0.05))
+        return True
+
+
+class _ScheduleDatetime:
+    """schedule 라이브러리 내부의 datetime.datetime.now() 를 교체하기 위한 대용 모듈"""
+
+    def __init__(self, clock: SystemClock):
+        class _Datetime(_datetime.datetime):
+            @classmethod
+            def now(cls, tz=None):
+                return clock.now(tz)
+
+        self.datetime = _Datetime
+        self.date = _datetime.date
+        self.time = _datetime.time
+        self.timedelta = _datetime.timedelta
+
+
+_clock: SystemClock = SystemClock()
+
+
+def install(clock: SystemClock):
+    """시계 교체 (schedule 라이브러리의 현재 시각도 같은 시계로 맞춤)"""
+    global _clock
+    _clock = clock
+
+    import schedule
+    schedule.datetime = _ScheduleDatetime(clock) if isinstance(clock, VirtualClock) else _datetime
+
+
+def current() -> SystemClock:
+    return _clock
+
+
+def now(tz: Optional[tzinfo] = None) -> datetime:
+    return _clock.now(tz)
+
+
+def time() -> float:
+    return _clock.time()
+
+
+def sleep(seconds: float):
+    _clock.sleep(seconds)
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 항목 추출・판정 함수
+Author: Manus AI
+Date: 2025-09-26
+
+앵커・피드 항목마다 호출되는 추출・판정 로직 (상태 없는 순수 함수, 시각・설정은 인수로 받음).
+대량 수집・백필에서 CPU 의 대부분을 차지하므로 gazetteer.py 와 함께 mypyc 로 컴파일할 수 있다.
+컴파일판(.so)이 없거나 인터프리터 버전이 맞지 않으면 이 소스가 그대로 사용된다.
+
+    mypyc extraction.py gazetteer.py   # 같은 디렉터리에 확장 모듈 생성 (삭제하면 순수 Python 판)
+"""
+
+import re
+import hashlib
+from datetime import datetime
+from typing import Optional, Pattern, Sequence, Tuple
+
+from gazetteer import Gazetteer
+
+# 컴파일판이면 __file__ 이 확장 모듈(.so/.pyd)을 가리킴
+COMPILED = not __file__.endswith('.py')
+
+# 판정할 수 없는 상태는 중요 상태로 취급하지 않음
+DEFAULT_STATUS = 'その他'
+
+LOCATION_PATTERNS = (
+    re.compile(r'(会議室|ホール|センター|ビル|会館)'),
+    re.compile(r'IN\s+([A-Z]+)'),
+    re.compile(r'in\s+([^\s]+)'),
+)
+
+# (패턴, 형식) 형식: 'reiwa' 령화 연호, 'ymd' 연월일, 'md' 월일만
+DATE_PATTERNS = (
+    (re.compile(r'令和(\d+)年(\d+)月(\d+)日'), 'reiwa'),
+    (re.compile(r'(\d{4})年(\d{1,2})月(\d{1,2})日'), 'ymd'),
+    (re.compile(r'(\d{1,2})月(\d{1,2})日'), 'md'),
+    (re.compile(r'(\d{4})/(\d{1,2})/(\d{1,2})'), 'ymd'),
+    (re.compile(r'(\d{4})-(\d{1,2})-(\d{1,2})'), 'ymd'),
+)
+
+DATE_FORMATS = (
+    '%a, %d %b %Y %H:%M:%S %z',
+    '%Y-%m-%d %H:%M:%S',
+    '%Y/%m/%d %H:%M:%S',
+    '%Y-%m-%d',
+    '%Y/%m/%d',
+)
+
+IMPORTANT_STATUSES = frozenset(('募集中', '募集締切', '開催予定'))
+IMPORTANT_KEYWORDS = ('募集開始', '満員', '締切', '開催予定')
+
+
+def contains_keywords(pattern: Pattern[str], text: str) -> bool:
+    """컴파일된 키워드 매처가 텍스트에 일치하는지"""
+    return pattern.search(text) is not None
+
+
+def detect_status(text: str, rules: Sequence[Tuple[str, str]]) -> str:
+    """상태 판정 (규칙의 정의 순서 우선, 일치 없으면 その他)"""
+    for keyword, status in rules:
+        if keyword in text:
+            return status
+    return DEFAULT_STATUS
+
+
+def extract_location(text: str, gazetteer: Gazetteer) -> Optional[str]:
+    """개최지 추출 (지명 사전 최장 일치 → 시설명・IN 표기 패턴)"""
+    place = gazetteer.find(text)
+    if place is not None:
+        return place.name
+
+    for pattern in LOCATION_PATTERNS:
+        match = pattern.search(text)
+        if match:
+            return match.group(1) if match.group(1) else match.group(0)
+    return None
+
+
+def extract_date(text: str, current_year: int) -> Optional[datetime]:
+    """본문의 날짜 (naive, 월일만 있으면 current_year), 없거나 존재하지 않는 날짜면 None"""
+    for pattern, kind in DATE_PATTERNS:
+        match = pattern.search(text)
+        if not match:
+            continue
+        if kind == 'reiwa':
+            year = 2018 + int(match.group(1))  # 령화 1년 = 2019년
+            month, day = int(match.group(2)), int(match.group(3))
+        elif kind == 'md':
+            year = current_year
+            month, day = int(match.group(1)), int(match.group(2))
+        else:
+            year, month, day = int(match.group(1)), int(match.group(2)), int(match.group(3))
+            if year < 100:  # 2자리 연도 처리
+                year += 2000
+        try:
+            return datetime(year, month, day)
+        except ValueError:
+            continue
+    return None
+
+
+def parse_date(date_str: str) -> Optional[datetime]:
+    """피드의 날짜 문자열 (시간대 표기가 없으면 naive), 해석할 수 없으면 None"""
+    for fmt in DATE_FORMATS:
+        try:
+            return datetime.strptime(date_str, fmt)
+        except (ValueError, TypeError):
+            continue
+    return None
+
+
+def seminar_hash(title: str, event_date: object, status: str) -> str:
+    """중복 판정용 해시 (제목・개최일・상태, 개최일은 str() 표기 그대로 - 저장된 해시와 호환)"""
+    return hashlib.sha256(f"{title}{event_date}{status}".encode('utf-8')).hexdigest()
+
+
+def is_important(status: str, title: str, raw_text: str) -> bool:
+    """중요 정보 판정 (상태 또는 본문 키워드)"""
+    if status in IMPORTANT_STATUSES:
+        return True
+    text = f"{title} {raw_text}".lower()
+    for keyword in IMPORTANT_KEYWORDS:
+        if keyword in text:
+            return True
+    return False
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - HTTP 취득 계층
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import time
+import logging
+import threading
+from typing import Callable, Dict, Hashable, List, Optional, Tuple
+from urllib.parse import urlparse
+import requests
+from requests.adapters import HTTPAdapter
+
+logger = logging.getLogger(__name__)
+
+# Prometheus 지표: (이름, 종류, 설명, host_stats 키)
+FETCH_METRICS = (
+    ('seminar_fetch_concurrency_limit', 'gauge', 'Adaptive per-host concurrency limit', 'limit'),
+    ('seminar_fetch_inflight', 'gauge', 'Requests currently in flight', 'inflight'),
+    ('seminar_fetch_latency_seconds', 'gauge', 'Smoothed response latency', 'latency_ewma'),
+    ('seminar_fetch_requests_total', 'counter', 'Requests sent', 'requests'),
+    ('seminar_fetch_errors_total', 'counter', 'Failed or overloaded responses', 'errors'),
+    ('seminar_fetch_limit_decreases_total', 'counter', 'Multiplicative decreases of the limit', 'decreases'),
+)
+
+
+class SingleFlight:
+    """같은 키의 작업을 실행 단위로 1회만 수행하고 결과를 공유"""
+
+    class _Call:
+        def __init__(self):
+            self.done = threading.Event()
+            self.result = None
+            self.error = None
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._calls: Dict[Hashable, 'SingleFlight._Call'] = {}
+        self.hits = 0
+
+    def do(self, key: Hashable, fn: Callable):
+        with self._lock:
+            call = self._calls.get(key)
+            leader = call is None
+            if leader:
+                call = self._calls[key] = self._Call()
+            else:
+                self.hits += 1
+
+        if leader:
+            try:
+                call.result = fn()
+            except Exception as e:
+                call.error = e
+            finally:
+                call.done.set()
+        else:
+            call.done.wait()
+
+        if call.error is not None:
+            raise call.error
+        return call.result
+
+    def reset(self):
+        with self._lock:
+            self._calls.clear()
+            self.hits = 0
+
+
+class AimdLimiter:
+    """호스트별 동시 요청 상한을 AIMD로 조정 (지연 증가・오류 시 배수 감소, 상한까지 쓰인 상태의 정상 응답마다 가산 증가)"""
+
+    def __init__(self, host: str, initial: float, minimum: float, maximum: float,
+                 tolerance: float, decrease_factor: float, latency_floor: float):
+        self.host = host
+        self.limit = float(initial)
+        self.minimum = float(minimum)
+        self.maximum = float(maximum)
+        self.tolerance = tolerance
+        self.decrease_factor = decrease_factor
+        self.latency_floor = latency_floor
+        self.inflight = 0
+        self.baseline: Optional[float] = None  # 관측 최소 지연 (서서히 상향 보정)
+        self.latency_ewma: Optional[float] = None
+        self.requests = 0
+        self.errors = 0
+        self.decreases = 0
+        self._last_decrease = 0.0
+        self._cond = threading.Condition()
+
+    def acquire(self, cap: Optional[int] = None) -> float:
+        """슬롯 확보 (cap: 메모리 압박 등 외부 요인에 의한 추가 상한)"""
+        with self._cond:
+            while self.inflight >= min(int(self.limit), cap or int(self.maximum)):
+                self._cond.wait()
+            self.inflight += 1
+        return time.monotonic()
+
+    def release(self, started: float, ok: bool):
+        now = time.monotonic()
+        latency = now - started
+        with self._cond:
+            saturated = self.inflight >= int(self.limit)  # 상한까지 채워져 있었을 때만 늘림 (수요가 없으면 상한 유지)
+            self.inflight -= 1
+            self.requests += 1
+            if ok:
+                self.latency_ewma = latency if self.latency_ewma is None else 0.8 * self.latency_ewma + 0.2 * latency
+                self.baseline = latency if self.baseline is None else min(latency, self.baseline + 0.01 * (latency - self.baseline))
+                congested = latency > max(self.baseline * self.tolerance, self.latency_floor)
+            else:
+                self.errors += 1
+                congested = True
+
+            if congested:
+                # 같은 혼잡에 대한 연속 감소를 막기 위해 감소는 지연 1회분 간격 이상으로
+                if now - self._last_decrease >= (self.latency_ewma or latency):
+                    self.limit = max(self.minimum, self.limit * self.decrease_factor)
+                    self._last_decrease = now
+                    self.decreases += 1
+            elif saturated:
+                # 상한만큼 응답이 돌아오면 +1
+                self.limit = min(self.maximum, self.limit + 1.0 / self.limit)
+            self._cond.notify_all()
+
+    def snapshot(self) -> Dict:
+        with self._cond:
+            return {'host': self.host, 'limit': self.limit, 'inflight': self.inflight,
+                    'latency_ewma': self.latency_ewma, 'baseline': self.baseline,
+                    'requests': self.requests, 'errors': self.errors, 'decreases': self.decreases}
+
+
+class FetchResult:
+    """취득 결과 (트레이스용 시각 포함)"""
+
+    def __init__(self, url: str, status_code: int, content: bytes, started_ns: int, ended_ns: int,
+                 etag: str = None, last_modified: str = None):
+        self.url = url
+        self.status_code = status_code
+        self.content = content
+        self.started_ns = started_ns
+        self.ended_ns = ended_ns
+        self.etag = etag
+        self.last_modified = last_modified
+
+    @property
+    def not_modified(self) -> bool:
+        return self.status_code == 304
+
+
+class Fetcher:
+    """커넥션 풀을 공유하고, 실행 내 동일 URL 요청을 1회로 합침"""
+
+    def __init__(self, timeout: float = None, memory=None):
+        self.memory = memory  # memory_monitor.ProcessMemory (메모리 압박 시 호스트별 동시 요청 수 축소)
+        self.timeout = timeout or float(os.getenv('REQUEST_TIMEOUT', '30'))
+        self.flight = SingleFlight()
+        self.requests_sent = 0
+        self._sent_lock = threading.Lock()
+        self._active_runs = 0  # 여러 테넌트가 공유할 때 겹쳐 있는 실행 수
+        self._runs_lock = threading.Lock()
+
+        # 호스트별 적응형 동시성 (상한은 실행 간에도 유지)
+        self.concurrency_initial = float(os.getenv('FETCH_CONCURRENCY_INITIAL', '2'))
+        self.concurrency_min = float(os.getenv('FETCH_CONCURRENCY_MIN', '1'))
+        self.concurrency_max = float(os.getenv('FETCH_CONCURRENCY_MAX', '16'))
+        self.latency_tolerance = float(os.getenv('FETCH_LATENCY_TOLERANCE', '2.0'))
+        self.latency_floor = float(os.getenv('FETCH_LATENCY_FLOOR_MS', '300')) / 1000
+        self.limiters: Dict[str, AimdLimiter] = {}
+        self._limiters_lock = threading.Lock()
+
+        self.session = requests.Session()
+        adapter = HTTPAdapter(pool_maxsize=int(self.concurrency_max))
+        self.session.mount('http://', adapter)
+        self.session.mount('https://', adapter)
+
+    def begin_run(self):
+        """실행 시작 시 이전 실행의 결과를 비움 (다른 테넌트의 실행이 진행 중이면 결과를 계속 공유)"""
+        with self._runs_lock:
+            if self._active_runs == 0:
+                self.flight.reset()
+                self.requests_sent = 0
+            self._active_runs += 1
+
+    def end_run(self):
+        with self._runs_lock:
+            self._active_runs = max(0, self._active_runs - 1)
+
+    def get(self, url: str, headers: Optional[Dict[str, str]] = None) -> FetchResult:
+        """GET (headers에 If-None-Match 등을 넘기면 조건부 요청)"""
+        # 검증자가 다른 조건부 요청은 응답(304 여부)이 달라지므로 별도로 취득
+        key = ('GET', url, tuple(sorted(headers.items())) if headers else None)
+        return self.flight.do(key, lambda: self._get(url, headers))
+
+    def recorded(self) -> Dict[Hashable, Tuple[Optional[FetchResult], Optional[Exception]]]:
+        """현재 실행에서 완료된 GET 결과 (요청 키 → (결과, 예외)), 섀도 실행의 재생용"""
+        with self.flight._lock:
+            calls = list(self.flight._calls.items())
+        return {key: (call.result, call.error) for key, call in calls
+                if key[0] == 'GET' and call.done.is_set()}
+
+    def limiter_for(self, url: str) -> AimdLimiter:
+        host = urlparse(url).netloc
+        with self._limiters_lock:
+            limiter = self.limiters.get(host)
+            if limiter is None:
+                limiter = self.limiters[host] = AimdLimiter(
+                    host, self.concurrency_initial, self.concurrency_min, self.concurrency_max,
+                    self.latency_tolerance, 0.5, self.latency_floor)
+            return limiter
+
+    def _get(self, url: str, headers: Optional[Dict[str, str]]) -> FetchResult:
+        limiter = self.limiter_for(url)
+        cap = self.memory.scale(int(limiter.maximum)) if self.memory else None
+        slot_started = limiter.acquire(cap)
+        ok = False
+        try:
+            started = time.time_ns()
+            response = self.session.get(url, headers=headers, timeout=self.timeout)
+            # 429・5xx는 과부하 신호, 그 외 4xx는 요청 측 문제이므로 감소 대상에서 제외
+            ok = response.status_code != 429 and response.status_code < 500
+        finally:
+            limiter.release(slot_started, ok)
+        with self._sent_lock:
+            self.requests_sent += 1
+        response.raise_for_status()
+        return FetchResult(url, response.status_code, response.content, started, time.time_ns(),
+                           etag=response.headers.get('ETag'),
+                           last_modified=response.headers.get('Last-Modified'))
+
+    def log_stats(self):
+        logger.info(f"HTTP取得: {self.requests_sent}件, 重複要求の共有: {self.flight.hits}件")
+        for stats in self.host_stats():
+            logger.info(f"同時接続上限 {stats['host']}: {stats['limit']:.1f} "
+                        f"(要求{stats['requests']}件, エラー{stats['errors']}件, 減少{stats['decreases']}回)")
+
+    def host_stats(self) -> List[Dict]:
+        with self._limiters_lock:
+            limiters = list(self.limiters.values())
+        return [limiter.snapshot() for limiter in limiters]
+
+    def metrics(self) -> List[str]:
+        """Prometheus 텍스트 형식의 호스트별 지표"""
+        host_stats = self.host_stats()
+        lines = []
+        for name, kind, description, key in FETCH_METRICS:
+            lines.append(f'# HELP {name} {description}')
+            lines.append(f'# TYPE {name} {kind}')
+            for stats in host_stats:
+                if stats[key] is not None:
+                    lines.append(f'{name}{{host="{stats["host"]}"}} {stats[key]:g}')
+        return lines
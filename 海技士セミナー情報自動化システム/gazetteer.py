@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 로컬 지명 사전 및 근접 검색
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import math
+import unicodedata
+from collections import defaultdict
+from typing import Dict, Hashable, List, Optional, Tuple
+
+EARTH_RADIUS_KM = 6371.0
+
+# 접미어가 붙은 이름(津市・中津港)은 뒤에 무엇이 와도 지명으로 인정
+PLACE_SUFFIXES = '市港町村区郡県都府道'
+# 접미어 없는 이름 바로 뒤에 와도 지명으로 보는 말 (広島会場・神戸開催)
+PLACE_FOLLOWERS = ('会場', '開催', '地区', '市内', '大学', '港', '市', '駅')
+
+
+class Place:
+    """지명 사전 항목 (시정촌・항만・도도부현)"""
+
+    def __init__(self, name: str, kind: str, prefecture: str, lat: float, lon: float):
+        self.name = name
+        self.kind = kind
+        self.prefecture = prefecture
+        self.lat = lat
+        self.lon = lon
+
+
+def haversine_km(lat1: float, lon1: float, lat2: float, lon2: float) -> float:
+    phi1, phi2 = math.radians(lat1), math.radians(lat2)
+    dphi = phi2 - phi1
+    dlambda = math.radians(lon2 - lon1)
+    a = math.sin(dphi / 2) ** 2 + math.cos(phi1) * math.cos(phi2) * math.sin(dlambda / 2) ** 2
+    return 2 * EARTH_RADIUS_KM * math.asin(math.sqrt(a))
+
+
+def _normalize(text: str) -> str:
+    # 전각 영숫자 통일, 영문은 대문자로 비교 (IN KOBE / in Kobe)
+    return unicodedata.normalize('NFKC', text).upper()
+
+
+def _script(char: str) -> str:
+    if '\u4e00' <= char <= '\u9fff' or char in '々ヶ':
+        return 'kanji'
+    if '\u30a0' <= char <= '\u30ff':
+        return 'katakana'
+    if char.isascii() and char.isalnum():
+        return 'latin'
+    return ''
+
+
+def _joined(left: str, right: str) -> bool:
+    """같은 문자 종류가 이어지면 한 단어로 간주 (東+広島, 広島+大学)"""
+    script = _script(left)
+    return script != '' and script == _script(right)
+
+
+class Gazetteer:
+    """지명・별칭을 문자 트라이로 컴파일해 최장 일치로 검색 (외부 지오코딩 서비스 불필요)
+
+    단어 중간의 부분 일치(津波・東広島)를 막기 위해 지명은 단어 경계에서 시작해야 하고,
+    접미어 없는 이름은 뒤도 단어 경계이거나 PLACE_FOLLOWERS 여야 한다. 한 글자 이름은 받지 않는다.
+    """
+
+    _END = ''
+
+    def __init__(self, entries: List[Dict]):
+        self._trie: Dict = {}
+        self._by_name: Dict[str, Place] = {}
+        self._count = len(entries)
+        for entry in entries:
+            place = Place(entry['name'], entry.get('kind', 'municipality'), entry.get('prefecture', ''),
+                          float(entry['lat']), float(entry['lon']))
+            for name in [entry['name'], *entry.get('aliases', [])]:
+                if len(name) < 2:
+                    raise ValueError(f"地名辞書に1文字の地名は登録できません（市・港などを付けてください）: {name}")
+                self._insert(_normalize(name), place)
+
+    def __len__(self) -> int:
+        return self._count
+
+    def _insert(self, key: str, place: Place):
+        node = self._trie
+        for char in key:
+            node = node.setdefault(char, {})
+        node[self._END] = place
+        self._by_name[key] = place
+
+    def lookup(self, name: Optional[str]) -> Optional[Place]:
+        """이름・별칭 완전 일치"""
+        return self._by_name.get(_normalize(name)) if name else None
+
+    def matches(self, text: str) -> List[Tuple[int, Place]]:
+        """왼쪽부터 최장 일치로 겹치지 않는 지명 목록 (단어 경계를 만족하는 일치만)"""
+        text = _normalize(text)
+        found = []
+        i = 0
+        last_end = 0
+        while i < len(text):
+            # 직전 지명에 바로 이어지는 경우(広島県呉市)는 경계로 취급
+            if text[i] not in self._trie or (i > 0 and i != last_end and _joined(text[i - 1], text[i])):
+                i += 1
+                continue
+            node = self._trie
+            match, match_end = None, i
+            j = i
+            while j < len(text) and text[j] in node:
+                node = node[text[j]]
+                j += 1
+                if self._END in node and self._ends_word(text, j):
+                    match, match_end = node[self._END], j
+            if match:
+                found.append((i, match))
+                i = last_end = match_end
+            else:
+                i += 1
+        return found
+
+    @staticmethod
+    def _ends_word(text: str, end: int) -> bool:
+        if end == len(text) or text[end - 1] in PLACE_SUFFIXES or not _joined(text[end - 1], text[end]):
+            return True
+        return text.startswith(PLACE_FOLLOWERS, end)
+
+    def find(self, text: str) -> Optional[Place]:
+        """본문의 개최지 추정 (도도부현보다 시정촌・항만을 우선)"""
+        found = self.matches(text)
+        for _, place in found:
+            if place.kind != 'prefecture':
+                return place
+        return found[0][1] if found else None
+
+
+class GridIndex:
+    """위경도 격자 공간 색인 (반경 검색 시 주변 셀만 확인)"""
+
+    def __init__(self, cell_deg: float = 0.5):
+        self.cell_deg = cell_deg
+        self._cells: Dict[Tuple[int, int], List[Tuple[Hashable, float, float]]] = defaultdict(list)
+
+    def _cell(self, lat: float, lon: float) -> Tuple[int, int]:
+        return int(math.floor(lat / self.cell_deg)), int(math.floor(lon / self.cell_deg))
+
+    def add(self, key: Hashable, lat: float, lon: float):
+        self._cells[self._cell(lat, lon)].append((key, lat, lon))
+
+    def within(self, lat: float, lon: float, radius_km: float) -> List[Tuple[Hashable, float]]:
+        """반경 내 항목 (거리순)"""
+        dlat = radius_km / 111.0
+        dlon = radius_km / (111.0 * max(math.cos(math.radians(lat)), 0.01))
+        lat_min, lon_min = self._cell(lat - dlat, lon - dlon)
+        lat_max, lon_max = self._cell(lat + dlat, lon + dlon)
+
+        hits = []
+        for cell_lat in range(lat_min, lat_max + 1):
+            for cell_lon in range(lon_min, lon_max + 1):
+                for key, item_lat, item_lon in self._cells.get((cell_lat, cell_lon), ()):
+                    distance = haversine_km(lat, lon, item_lat, item_lon)
+                    if distance <= radius_km:
+                        hits.append((key, distance))
+        return sorted(hits, key=lambda hit: hit[1])
@@ -8,9 +8,9 @@ Date: 2025-09-26
 
 import sqlite3
 import sys
-import os
 from datetime import datetime, timedelta
 import pytz
+from settings import Settings
 
 # 일본 표준시 타임존 설정
 JST = pytz.timezone('Asia/Tokyo')
@@ -18,11 +18,11 @@ JST = pytz.timezone('Asia/Tokyo')
 def health_check():
     """시스템 헬스체크"""
     try:
-        # 환경 변수에서 DB 경로 가져오기
-        db_path = os.environ.get('DB_PATH', '/app/data/seminar_automation.db')
+        # 스케줄러와 같은 설정에서 DB 경로・대기 시간 가져오기
+        settings = Settings.from_env()
         
         # 데이터베이스 연결 확인
-        conn = sqlite3.connect(db_path)
+        conn = sqlite3.connect(settings.db_path, timeout=settings.db_timeout)
         cursor = conn.cursor()
         
         # 기본 테이블 존재 확인
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 구독자별 iCalendar 피드
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import hashlib
+import logging
+import secrets
+import sqlite3
+import threading
+from datetime import date, datetime, timedelta
+from typing import Callable, Dict, Optional, Tuple
+
+import pytz
+
+from gazetteer import Gazetteer, haversine_km
+import clock
+
+logger = logging.getLogger(__name__)
+
+JST = pytz.timezone('Asia/Tokyo')
+
+PRODID = '-//Kaigishi Seminar Automation//JA'
+
+
+def _escape(value: str) -> str:
+    """RFC 5545 TEXT 이스케이프"""
+    return (value.replace('\\', '\\\\').replace(';', '\\;').replace(',', '\\,')
+            .replace('\r\n', '\\n').replace('\n', '\\n'))
+
+
+def _fold(line: str) -> str:
+    """75옥텟 단위 줄 접기 (UTF-8 문자 중간에서 자르지 않음)"""
+    encoded = line.encode('utf-8')
+    if len(encoded) <= 75:
+        return line + '\r\n'
+    parts = []
+    current, size, limit = [], 0, 75
+    for char in line:
+        char_size = len(char.encode('utf-8'))
+        if size + char_size > limit:
+            parts.append(''.join(current))
+            current, size, limit = [], 0, 74  # 연속 줄은 선두 공백 1옥텟
+        current.append(char)
+        size += char_size
+    parts.append(''.join(current))
+    return '\r\n '.join(parts) + '\r\n'
+
+
+def render_vevent(seminar: Dict) -> str:
+    """세미나 1건의 VEVENT 조각 (개최일 단위 종일 일정)"""
+    day = date.fromisoformat(str(seminar['event_date'])[:10])
+    created = str(seminar.get('created_at') or '')[:19]
+    stamp = (datetime.fromisoformat(created).strftime('%Y%m%dT%H%M%SZ') if created
+             else datetime.utcnow().strftime('%Y%m%dT%H%M%SZ'))
+
+    description = f"状態: {seminar['status']}\n{seminar['source_url']}"
+    lines = [
+        'BEGIN:VEVENT',
+        f"UID:seminar-{seminar['seminar_id']}@seminar-automation",
+        f"DTSTAMP:{stamp}",
+        f"DTSTART;VALUE=DATE:{day.strftime('%Y%m%d')}",
+        f"DTEND;VALUE=DATE:{(day + timedelta(days=1)).strftime('%Y%m%d')}",
+        f"SUMMARY:{_escape(seminar['title'])}",
+        f"DESCRIPTION:{_escape(description)}",
+        f"URL:{seminar['source_url']}",
+    ]
+    if seminar.get('location'):
+        lines.append(f"LOCATION:{_escape(seminar['location'])}")
+    if seminar.get('latitude') is not None:
+        lines.append(f"GEO:{seminar['latitude']:.4f};{seminar['longitude']:.4f}")
+    lines.append('END:VEVENT')
+    return ''.join(_fold(line) for line in lines)
+
+
+class CalendarFeeds:
+    """VEVENT 조각을 세미나당 1회 렌더링해 저장하고, 구독자 필터에 맞는 조각을 연결해 피드 구성"""
+
+    def __init__(self, connect: Callable[[], sqlite3.Connection], gazetteer: Callable[[], Gazetteer]):
+        self.connect = connect  # 실행 컨텍스트의 DB 연결 (DB_TIMEOUT 적용)
+        self.gazetteer = gazetteer  # 설정 재로드를 반영하도록 호출 시점에 취득
+        self.past_days = int(os.getenv('CALENDAR_PAST_DAYS', '30'))
+        self._cache: Dict[int, Tuple[tuple, str, bytes]] = {}  # subscriber_id → (버전 키, ETag, 본문)
+        self._lock = threading.Lock()
+
+    def refresh_fragments(self) -> int:
+        """조각이 없는 세미나만 렌더링 (기동 시・수집 후에 호출, 요청 처리에서는 저장된 조각만 사용)"""
+        conn = self.connect()
+        conn.row_factory = sqlite3.Row
+        try:
+            rows = conn.execute('''
+                SELECT s.seminar_id, s.title, s.event_date, s.location, s.status, s.source_url, s.created_at,
+                       v.latitude, v.longitude
+                FROM seminars s
+                LEFT JOIN seminar_venues v ON v.seminar_id = s.seminar_id
+                LEFT JOIN seminar_vevents e ON e.seminar_id = s.seminar_id
+                WHERE e.seminar_id IS NULL AND s.event_date IS NOT NULL
+            ''').fetchall()
+            with conn:
+                for row in rows:
+                    fragment = render_vevent(dict(row))
+                    conn.execute('''
+                        INSERT OR REPLACE INTO seminar_vevents (seminar_id, fragment, fragment_hash)
+                        VALUES (?, ?, ?)
+                    ''', (row['seminar_id'], fragment, hashlib.sha1(fragment.encode('utf-8')).hexdigest()))
+            if rows:
+                logger.info(f"カレンダー断片生成: {len(rows)}件")
+            return len(rows)
+        finally:
+            conn.close()
+
+    def token_for(self, subscriber_id: int) -> str:
+        """구독자의 피드 토큰 (없으면 발급)"""
+        conn = self.connect()
+        try:
+            row = conn.execute('SELECT token FROM subscriber_calendars WHERE subscriber_id = ?',
+                               (subscriber_id,)).fetchone()
+            if row:
+                return row[0]
+            token = secrets.token_urlsafe(24)
+            with conn:
+                conn.execute('INSERT INTO subscriber_calendars (subscriber_id, token) VALUES (?, ?)',
+                             (subscriber_id, token))
+            return token
+        finally:
+            conn.close()
+
+    def feed(self, token: str, if_none_match: Optional[str] = None) -> Tuple[int, Optional[str], bytes]:
+        """(HTTP 상태, ETag, 본문) - 구독자 없음은 404, 변경 없음은 304"""
+        conn = self.connect()
+        try:
+            row = conn.execute('''
+                SELECT c.subscriber_id, s.region_id FROM subscriber_calendars c
+                JOIN subscribers s ON s.subscriber_id = c.subscriber_id
+                WHERE c.token = ?
+            ''', (token,)).fetchone()
+            if row is None:
+                return 404, None, b''
+            subscriber_id, region_id = row
+            proximity = tuple(conn.execute(
+                'SELECT place, radius_km FROM subscriber_proximity WHERE subscriber_id = ? ORDER BY place',
+                (subscriber_id,)).fetchall())
+
+            # 조각 테이블의 최신 rowid・건수와 필터가 같으면 이전에 조립한 피드를 재사용
+            today = clock.now(JST).date()
+            version = (conn.execute('SELECT MAX(rowid), COUNT(*) FROM seminar_vevents').fetchone(),
+                       region_id, proximity, today)
+            with self._lock:
+                cached = self._cache.get(subscriber_id)
+            if cached is None or cached[0] != version:
+                etag, body = self._assemble(conn, region_id, proximity, today)
+                cached = (version, etag, body)
+                with self._lock:
+                    self._cache[subscriber_id] = cached
+        finally:
+            conn.close()
+
+        _, etag, body = cached
+        if if_none_match and etag in [tag.strip() for tag in if_none_match.split(',')]:
+            return 304, etag, b''
+        return 200, etag, body
+
+    def _assemble(self, conn: sqlite3.Connection, region_id: Optional[int],
+                  proximity: tuple, today: date) -> Tuple[str, bytes]:
+        since = (today - timedelta(days=self.past_days)).isoformat()
+        fragments: Dict[int, Tuple[str, str, str]] = {}
+
+        for seminar_id, event_date, fragment, fragment_hash in conn.execute('''
+            SELECT s.seminar_id, s.event_date, e.fragment, e.fragment_hash
+            FROM seminar_regions sr
+            JOIN seminars s ON s.seminar_id = sr.seminar_id
+            JOIN seminar_vevents e ON e.seminar_id = s.seminar_id
+            WHERE sr.region_id = ? AND s.event_date >= ?
+        ''', (region_id, since)):
+            fragments[seminar_id] = (event_date, fragment, fragment_hash)
+
+        gazetteer = self.gazetteer()
+        for place_name, radius_km in proximity:
+            center = gazetteer.lookup(place_name)
+            if center is None:
+                continue
+            # 위경도 경계 상자로 후보를 좁힌 뒤 거리로 판정
+            dlat = radius_km / 111.0
+            dlon = radius_km / 80.0  # 일본 위도대(북위 24~46도)에서 경도 1도 ≥ 약 80km
+            for seminar_id, event_date, fragment, fragment_hash, lat, lon in conn.execute('''
+                SELECT s.seminar_id, s.event_date, e.fragment, e.fragment_hash, v.latitude, v.longitude
+                FROM seminar_venues v
+                JOIN seminars s ON s.seminar_id = v.seminar_id
+                JOIN seminar_vevents e ON e.seminar_id = v.seminar_id
+                WHERE v.latitude BETWEEN ? AND ? AND v.longitude BETWEEN ? AND ? AND s.event_date >= ?
+            ''', (center.lat - dlat, center.lat + dlat, center.lon - dlon, center.lon + dlon, since)):
+                if haversine_km(center.lat, center.lon, lat, lon) <= radius_km:
+                    fragments[seminar_id] = (event_date, fragment, fragment_hash)
+
+        ordered = sorted(fragments.items(), key=lambda item: (str(item[1][0]), item[0]))
+        etag = '"' + hashlib.sha1(','.join(item[1][2] for item in ordered).encode('utf-8')).hexdigest() + '"'
+        body = ''.join([
+            'BEGIN:VCALENDAR\r\n',
+            'VERSION:2.0\r\n',
+            f'PRODID:{PRODID}\r\n',
+            'CALSCALE:GREGORIAN\r\n',
+            _fold('X-WR-CALNAME:海技士セミナー'),
+            *(item[1][1] for item in ordered),
+            'END:VCALENDAR\r\n',
+        ])
+        return etag, body.encode('utf-8')
+
+    def endpoint(self, query: Dict, headers: Dict):
+        """/calendar/<token>.ics - 관리 서버용 핸들러"""
+        token = query['_path'].rsplit('/', 1)[-1]
+        if token.endswith('.ics'):
+            token = token[:-4]
+        if_none_match = next((value for key, value in headers.items() if key.lower() == 'if-none-match'), None)
+
+        status, etag, body = self.feed(token, if_none_match)
+        if status == 404:
+            return 404, 'application/json', {'error': 'not found'}
+        extra_headers = {'ETag': etag, 'Cache-Control': 'private, max-age=300'}
+        return status, 'text/calendar', body, extra_headers
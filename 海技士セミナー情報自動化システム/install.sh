@@ -47,6 +47,18 @@ EOF
 
 echo "✅ 環境設定ファイル(.env)を作成しました"
 
+# 設定ディレクトリ準備（./config は読み取り専用でマウントされ、無いと空ディレクトリになり起動に失敗する）
+if [ ! -f config/regional_transport_bureaus.json ]; then
+    echo "📁 設定ディレクトリ(./config)をイメージの既定値から作成中..."
+    mkdir -p config
+    IMAGE=$(docker-compose -f docker-compose.production.yml config | awk '/image:/ {print $2; exit}')
+    docker pull "$IMAGE" > /dev/null
+    CONTAINER=$(docker create "$IMAGE")
+    docker cp "$CONTAINER:/app/config/." config/
+    docker rm "$CONTAINER" > /dev/null
+    echo "✅ 設定ディレクトリ(./config)を作成しました"
+fi
+
 # システム開始
 echo ""
 echo "🚀 システムを開始中..."
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 작업 실행기
+Author: Manus AI
+Date: 2025-09-26
+
+schedule.run_pending() 에서는 작업 투입만 하고, 실행은 워커 풀에서 수행한다.
+- 레인: 장시간 작업(메인 프로세스)과 단시간 작업(상태 확인)의 풀을 분리해
+  짧은 작업이 긴 작업 뒤에서 기다리지 않도록 함
+- 그룹: 동시 실행 수 상한 단위 (메인 프로세스와 재시도는 같은 그룹)
+- 중복 정책: 상한에 도달했을 때 새 투입의 처리
+    skip   : 버림
+    queue  : 1건만 보류하고 실행 중인 작업이 끝나면 실행 (여러 번 투입해도 1건)
+    cancel : 실행 중인 작업에 취소를 통지하고, 종료 후 새 작업을 실행
+- 테넌트: 여러 테넌트가 실행기를 공유할 때 레인의 빈 워커를 테넌트 간 라운드 로빈으로 배정
+  (같은 시각에 투입이 몰려도 한 테넌트의 작업이 워커를 독점하지 않음)
+"""
+
+import os
+import logging
+import threading
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, Deque, Dict, List, Optional
+
+logger = logging.getLogger(__name__)
+
+OVERLAP_POLICIES = ('skip', 'queue', 'cancel')
+
+
+class JobSpec:
+    def __init__(self, name: str, fn: Callable, lane: str = 'short', group: Optional[str] = None,
+                 overlap: str = 'skip', cancellable: bool = False, tenant: Optional[str] = None):
+        # 환경 변수 JOB_OVERLAP_<NAME> 으로 중복 정책 재정의 가능
+        overlap = os.getenv(f'JOB_OVERLAP_{name.upper()}', overlap)
+        if overlap not in OVERLAP_POLICIES:
+            raise ValueError(f"不正な重複ポリシー: {name}={overlap}")
+        # 테넌트 작업은 이름・그룹을 '<테넌트>/<이름>' 으로 구분
+        prefix = f'{tenant}/' if tenant else ''
+        self.name = prefix + name
+        self.fn = fn
+        self.lane = lane
+        self.group = prefix + (group or name)
+        self.tenant = tenant
+        self.overlap = overlap
+        self.cancellable = cancellable  # True 이면 fn(cancel_event) 로 호출
+
+
+class _Run:
+    def __init__(self, spec: JobSpec):
+        self.spec = spec
+        self.cancel_event = threading.Event()
+
+
+class JobExecutor:
+    def __init__(self, lanes: Optional[Dict[str, int]] = None, group_limits: Optional[Dict[str, int]] = None):
+        lanes = lanes or {'long': int(os.getenv('LONG_JOB_WORKERS', '2')),
+                          'short': int(os.getenv('SHORT_JOB_WORKERS', '2'))}
+        self._pools = {lane: ThreadPoolExecutor(max_workers=workers, thread_name_prefix=f'job-{lane}')
+                       for lane, workers in lanes.items()}
+        self._workers = dict(lanes)
+        self._idle = dict(lanes)  # 레인별 빈 워커 수
+        self._waiting: Dict[str, Dict[Optional[str], Deque[_Run]]] = {lane: {} for lane in lanes}  # 레인 → 테넌트 → 워커 대기
+        self.group_limits = group_limits or {}
+        self.specs: Dict[str, JobSpec] = {}
+        self._running: Dict[str, List[_Run]] = {}
+        self._queued: Dict[str, List[JobSpec]] = {}
+        self._lock = threading.Lock()
+        self.stats = {'started': 0, 'skipped': 0, 'queued': 0, 'cancelled': 0, 'failed': 0}
+        self.on_finish: Optional[Callable[[], None]] = None  # 작업 종료마다 통지 (시뮬레이션용)
+
+    def register(self, spec: JobSpec):
+        if spec.lane not in self._pools:
+            raise ValueError(f"未定義のレーン: {spec.lane}")
+        self.specs[spec.name] = spec
+
+    def submit(self, name: str) -> bool:
+        """작업 투입 (schedule 에서 호출되며 즉시 반환) → 실행 시작 여부"""
+        spec = self.specs[name]
+        with self._lock:
+            running = self._running.setdefault(spec.group, [])
+            if len(running) < self.group_limits.get(spec.group, 1):
+                self._start(spec)
+                return True
+
+            if spec.overlap == 'skip':
+                self.stats['skipped'] += 1
+                logger.warning(f"ジョブをスキップ（{spec.group}実行中）: {name}")
+                return False
+
+            queued = self._queued.setdefault(spec.group, [])
+            if any(item.name == name for item in queued):
+                logger.info(f"ジョブは保留済みです: {name}")
+                return False
+            self.stats['queued'] += 1
+
+            if spec.overlap == 'cancel':
+                queued.insert(0, spec)  # 취소한 작업 다음에 실행
+                for run in running:
+                    if not run.cancel_event.is_set():
+                        run.cancel_event.set()
+                        self.stats['cancelled'] += 1
+                        logger.warning(f"実行中のジョブに取消を通知: {run.spec.name}（{name}を優先）")
+            else:
+                queued.append(spec)
+                logger.info(f"ジョブを保留（{spec.group}実行中）: {name}")
+            return False
+
+    def _start(self, spec: JobSpec):
+        # 호출자가 self._lock 을 보유하고 있어야 함
+        run = _Run(spec)
+        self._running[spec.group].append(run)
+        self.stats['started'] += 1
+        if self._idle[spec.lane] > 0:
+            self._dispatch(run)
+        else:
+            self._waiting[spec.lane].setdefault(spec.tenant, deque()).append(run)
+
+    def _dispatch(self, run: _Run):
+        # 호출자가 self._lock 을 보유하고 있어야 함
+        self._idle[run.spec.lane] -= 1
+        self._pools[run.spec.lane].submit(self._execute, run)
+
+    def _next_waiting(self, lane: str) -> Optional[_Run]:
+        """워커 대기 중인 테넌트를 라운드 로빈으로 선택 (선택된 테넌트는 맨 뒤로)"""
+        waiting = self._waiting[lane]
+        if not waiting:
+            return None
+        tenant = next(iter(waiting))
+        runs = waiting.pop(tenant)
+        run = runs.popleft()
+        if runs:
+            waiting[tenant] = runs
+        return run
+
+    def _execute(self, run: _Run):
+        spec = run.spec
+        try:
+            if spec.cancellable:
+                spec.fn(run.cancel_event)
+            else:
+                spec.fn()
+        except Exception as e:
+            with self._lock:
+                self.stats['failed'] += 1
+            logger.error(f"ジョブ実行中にエラー: {spec.name} - {str(e)}")
+        finally:
+            with self._lock:
+                self._running[spec.group].remove(run)
+                self._idle[spec.lane] += 1
+                waiting = self._next_waiting(spec.lane)
+                if waiting:
+                    self._dispatch(waiting)
+                queued = self._queued.get(spec.group)
+                if queued and len(self._running[spec.group]) < self.group_limits.get(spec.group, 1):
+                    self._start(queued.pop(0))
+            if self.on_finish:
+                self.on_finish()
+
+    def running(self) -> Dict[str, List[str]]:
+        with self._lock:
+            return {group: [run.spec.name for run in runs] for group, runs in self._running.items() if runs}
+
+    def busy(self) -> int:
+        with self._lock:
+            return sum(self._workers[lane] - self._idle[lane] for lane in self._workers)
+
+    def shutdown(self, cancel: bool = True):
+        """정지 (cancel=True 이면 실행 중 작업에 취소를 통지하고 종료를 기다림)"""
+        with self._lock:
+            self._queued.clear()
+            for waiting in self._waiting.values():
+                waiting.clear()
+            if cancel:
+                for runs in self._running.values():
+                    for run in runs:
+                        run.cancel_event.set()
+        for pool in self._pools.values():
+            pool.shutdown(wait=True)
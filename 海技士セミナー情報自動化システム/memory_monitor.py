@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 메모리 예산 관리
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import gc
+import os
+import time
+import logging
+import resource
+import threading
+import tracemalloc
+from contextlib import contextmanager
+from typing import Dict, Optional
+
+logger = logging.getLogger(__name__)
+
+
+class ProcessMemory:
+    """프로세스 단위 메모리 예산 (RSS・tracemalloc 은 프로세스 전역이므로 Runtime 에 1개, 테넌트 간 공유)
+
+    tracemalloc 은 실행 중인 실행이 하나라도 있으면 켜 두고, 단계별 할당량은 그 실행만 돌고 있는 동안에만 귀속한다
+    (다른 테넌트가 동시에 돌면 할당・피크를 구분할 수 없으므로 RSS・시간만 기록).
+    """
+
+    def __init__(self, budget_mb: float = None, soft_ratio: float = None, trace: bool = None):
+        self.budget_mb = budget_mb or float(os.getenv('MEMORY_BUDGET_MB', '400'))
+        self.soft_ratio = soft_ratio or float(os.getenv('MEMORY_SOFT_LIMIT_RATIO', '0.8'))
+        if trace is None:
+            trace = os.getenv('MEMORY_TRACEMALLOC', 'true').lower() in ('true', '1', 'yes')
+        self.trace = trace
+        self._active_runs = 0
+        self._epoch = 0  # 실행 시작마다 증가 (단계 측정 중에 다른 실행이 끼어들었는지 판정)
+        self._started_here = False
+        self._lock = threading.Lock()
+
+    def begin_run(self):
+        with self._lock:
+            self._active_runs += 1
+            self._epoch += 1
+            if self.trace and not tracemalloc.is_tracing():
+                tracemalloc.start()
+                self._started_here = True
+
+    def end_run(self):
+        with self._lock:
+            self._active_runs = max(0, self._active_runs - 1)
+            if self._active_runs == 0 and self._started_here:
+                tracemalloc.stop()
+                self._started_here = False
+
+    def begin_trace(self) -> Optional[int]:
+        """단독 실행 중이면 피크를 초기화하고 측정 토큰 반환 (동시 실행 중・추적 꺼짐은 None)"""
+        with self._lock:
+            if self._active_runs != 1 or not tracemalloc.is_tracing():
+                return None
+            tracemalloc.reset_peak()
+            return self._epoch
+
+    def still_exclusive(self, token: int) -> bool:
+        with self._lock:
+            return self._active_runs == 1 and self._epoch == token and tracemalloc.is_tracing()
+
+    def current_rss_mb(self) -> float:
+        """현재 RSS (MB)"""
+        try:
+            with open('/proc/self/statm', 'r') as f:
+                resident_pages = int(f.read().split()[1])
+            return resident_pages * os.sysconf('SC_PAGE_SIZE') / (1024 * 1024)
+        except (OSError, ValueError, IndexError):
+            return self.peak_rss_mb()
+
+    def peak_rss_mb(self) -> float:
+        """프로세스 최대 RSS (MB)"""
+        return resource.getrusage(resource.RUSAGE_SELF).ru_maxrss / 1024
+
+    def pressure(self) -> float:
+        """예산 대비 현재 사용률 (프로세스 전체, 컨테이너 제한과 같은 단위)"""
+        return self.current_rss_mb() / self.budget_mb
+
+    def under_pressure(self) -> bool:
+        """소프트 한계 도달 여부"""
+        return self.pressure() >= self.soft_ratio
+
+    def over_budget(self) -> bool:
+        """예산 초과 여부"""
+        return self.pressure() >= 1.0
+
+    def scale(self, value: int) -> int:
+        """메모리 압박에 따라 배치 크기・동시 실행 수를 축소"""
+        pressure = self.pressure()
+        if pressure >= 1.0:
+            return 1
+        if pressure >= self.soft_ratio:
+            return max(1, value // 4)
+        return value
+
+    def relieve(self):
+        """가비지 컬렉션으로 메모리 회수"""
+        before = self.current_rss_mb()
+        gc.collect()
+        logger.warning(f"メモリ逼迫のため回収を実施: {before:.1f}MB → {self.current_rss_mb():.1f}MB "
+                       f"(予算 {self.budget_mb:.0f}MB)")
+
+
+class MemoryMonitor:
+    """실행 단위 단계별 메모리 사용량 측정 (예산・압박 판정은 프로세스 공통 ProcessMemory 에 위임)"""
+
+    def __init__(self, process: ProcessMemory = None):
+        self.process = process or ProcessMemory()
+        self.stages = {}
+
+    @property
+    def budget_mb(self) -> float:
+        return self.process.budget_mb
+
+    @property
+    def soft_ratio(self) -> float:
+        return self.process.soft_ratio
+
+    def start(self):
+        """실행 단위 측정 시작"""
+        self.stages = {}
+        self.process.begin_run()
+
+    def stop(self):
+        """측정 종료"""
+        self.process.end_run()
+
+    @contextmanager
+    def stage(self, name: str):
+        """단계별 할당량/피크 기록"""
+        token = self.process.begin_trace()
+        if token is not None:
+            before, _ = tracemalloc.get_traced_memory()
+        rss_before = self.current_rss_mb()
+        started = time.monotonic()
+        try:
+            yield
+        finally:
+            record = self.stages.setdefault(name, {
+                'seconds': 0.0, 'allocated_mb': 0.0, 'peak_mb': 0.0, 'rss_delta_mb': 0.0, 'traced': True
+            })
+            record['seconds'] += time.monotonic() - started
+            record['rss_delta_mb'] += self.current_rss_mb() - rss_before
+            if token is not None and self.process.still_exclusive(token):
+                after, peak = tracemalloc.get_traced_memory()
+                record['allocated_mb'] += (after - before) / (1024 * 1024)
+                record['peak_mb'] = max(record['peak_mb'], (peak - before) / (1024 * 1024))
+            else:
+                record['traced'] = False
+
+    def current_rss_mb(self) -> float:
+        return self.process.current_rss_mb()
+
+    def peak_rss_mb(self) -> float:
+        return self.process.peak_rss_mb()
+
+    def pressure(self) -> float:
+        return self.process.pressure()
+
+    def under_pressure(self) -> bool:
+        return self.process.under_pressure()
+
+    def over_budget(self) -> bool:
+        return self.process.over_budget()
+
+    def scale(self, value: int) -> int:
+        return self.process.scale(value)
+
+    def relieve(self):
+        self.process.relieve()
+
+    def report(self) -> Dict:
+        """실행 단위 메모리 리포트 출력"""
+        for name, record in self.stages.items():
+            allocation = (f"割当 {record['allocated_mb']:+.1f}MB, ピーク {record['peak_mb']:.1f}MB"
+                          if record['traced'] else "割当 計測なし (同時実行中)")
+            logger.info(f"メモリ[{name}]: {allocation}, RSS {record['rss_delta_mb']:+.1f}MB, {record['seconds']:.2f}秒")
+
+        peak_rss = self.peak_rss_mb()
+        logger.info(f"最大RSS: {peak_rss:.1f}MB / 予算 {self.budget_mb:.0f}MB")
+        if peak_rss >= self.budget_mb * self.soft_ratio:
+            logger.warning(f"最大RSSがメモリ予算の{self.soft_ratio * 100:.0f}%を超えました")
+
+        return {'peak_rss_mb': peak_rss, 'budget_mb': self.budget_mb, 'stages': dict(self.stages)}
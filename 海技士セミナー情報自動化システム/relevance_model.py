@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 문자 n-gram 관련도・상태 분류기
+Author: Manus AI
+Date: 2025-09-26
+
+키워드 목록이 놓치는 표기 변형(예: 海技者育成, 船員確保)을 보완하기 위한 소형 분류기.
+- 특징: NFKC 정규화한 문자 1~3-gram을 해시해 고정 차원에 사상 (어휘 사전 불필요)
+- 관련도: 로지스틱 회귀 / 상태: 소프트맥스 회귀 (모두 로컬 학습)
+- 추론은 페이지 내 후보 앵커 전체를 한 번에 벡터화 (행렬 없이 가중치 gather + bincount)
+- numpy 또는 모델 파일이 없으면 키워드 매처만으로 판정 (학습은 `relevance_model.py train` 으로만 수행)
+"""
+
+import os
+import sys
+import json
+import logging
+import argparse
+import unicodedata
+from typing import Dict, List, Optional, Sequence, Tuple
+
+from extraction import DEFAULT_STATUS
+
+try:
+    import numpy as np
+except ImportError:  # 키워드 매처로 폴백
+    np = None
+
+logger = logging.getLogger(__name__)
+
+HASH_BITS = 14
+NGRAM_SIZES = (1, 2, 3)
+# n별로 다른 해시 공간을 쓰기 위한 승수 (홀수)
+NGRAM_SALTS = {1: 0x9E3779B1, 2: 0x85EBCA77, 3: 0xC2B2AE3D}
+
+DEFAULT_MODEL_PATH = '/app/data/relevance_model.npz'
+TRAINING_FILE = 'relevance_training.json'
+
+
+def _normalize(text: str) -> str:
+    return unicodedata.normalize('NFKC', text).lower()
+
+
+def hashed_ngrams(texts: Sequence[str]) -> Tuple['np.ndarray', 'np.ndarray', 'np.ndarray']:
+    """(n-gram 해시, 소속 행 번호, 행별 n-gram 수) - 전체 텍스트를 이어 붙여 한 번에 계산"""
+    normalized = [_normalize(text) for text in texts]
+    # 텍스트 사이에 코드 포인트 0을 구분자로 삽입
+    joined = '\0'.join(normalized) + '\0'
+    codes = np.frombuffer(joined.encode('utf-32-le'), dtype=np.uint32).astype(np.uint64)
+    lengths = np.array([len(text) for text in normalized], dtype=np.int64)
+    owner = np.repeat(np.arange(len(texts)), lengths + 1)
+
+    hashes, rows = [], []
+    for n in NGRAM_SIZES:
+        if len(codes) < n:
+            continue
+        windows = len(codes) - n + 1
+        value = np.zeros(windows, dtype=np.uint64)
+        valid = np.ones(windows, dtype=bool)
+        for offset in range(n):
+            part = codes[offset:offset + windows]
+            value = value * np.uint64(0x100000001B3) + part  # 오버플로는 2^64 모듈로 연산으로 취급
+            valid &= part != 0
+        value = (value * np.uint64(NGRAM_SALTS[n])) >> np.uint64(64 - HASH_BITS)  # 상위 비트 사용
+        hashes.append(value[valid])
+        rows.append(owner[:windows][valid])
+
+    hashes = np.concatenate(hashes).astype(np.int64) if hashes else np.zeros(0, dtype=np.int64)
+    rows = np.concatenate(rows) if rows else np.zeros(0, dtype=np.int64)
+    counts = np.bincount(rows, minlength=len(texts)).astype(np.float64)
+    return hashes, rows, counts
+
+
+class RelevanceModel:
+    """학습된 가중치 (생성 후 변경하지 않음)"""
+
+    def __init__(self, relevance_w, relevance_b: float, status_w, status_b, statuses: List[str]):
+        self.relevance_w = relevance_w
+        self.relevance_b = relevance_b
+        self.status_w = status_w
+        self.status_b = status_b
+        self.statuses = statuses
+
+    def predict(self, texts: Sequence[str]) -> Tuple['np.ndarray', List[str], 'np.ndarray']:
+        """(관련 확률, 상태, 상태 확률) - 페이지 단위 일괄 추론"""
+        hashes, rows, counts = hashed_ngrams(texts)
+        scale = 1.0 / np.sqrt(np.maximum(counts, 1.0))
+        size = len(texts)
+
+        logits = self.relevance_b + np.bincount(rows, weights=self.relevance_w[hashes], minlength=size) * scale
+        relevance = 1.0 / (1.0 + np.exp(-logits))
+
+        probs = _softmax(_class_logits(self.status_w, self.status_b, hashes, rows, scale, size))
+        best = probs.argmax(axis=1)
+        return relevance, [self.statuses[k] for k in best], probs[np.arange(size), best]
+
+    def save(self, path: str):
+        os.makedirs(os.path.dirname(path) or '.', exist_ok=True)
+        tmp_path = f"{path}.tmp.npz"
+        np.savez(tmp_path, relevance_w=self.relevance_w, relevance_b=np.array([self.relevance_b]),
+                 status_w=self.status_w, status_b=self.status_b, statuses=np.array(self.statuses),
+                 hash_bits=np.array([HASH_BITS]))
+        os.replace(tmp_path, path)
+
+    @classmethod
+    def load(cls, path: str) -> 'RelevanceModel':
+        with np.load(path) as data:
+            if int(data['hash_bits'][0]) != HASH_BITS:
+                raise ValueError("特徴次元が一致しません (再学習が必要)")
+            return cls(data['relevance_w'], float(data['relevance_b'][0]), data['status_w'], data['status_b'],
+                       [str(status) for status in data['statuses']])
+
+
+def train(examples: List[Dict], statuses: Sequence[str], epochs: int = 300,
+          learning_rate: float = 0.5, l2: float = 1e-4) -> RelevanceModel:
+    """전체 배치 AdaGrad (학습 데이터 수백 건 규모 가정, 희소 특징별로 학습률 조정)"""
+    dim = 1 << HASH_BITS
+    texts = [example['text'] for example in examples]
+    hashes, rows, counts = hashed_ngrams(texts)
+    scale = 1.0 / np.sqrt(np.maximum(counts, 1.0))
+    size = len(texts)
+
+    # 관련도 (이진)
+    labels = np.array([1.0 if example['relevant'] else 0.0 for example in examples])
+    relevance_w = np.zeros(dim)
+    relevance_b = 0.0
+    w_acc, b_acc = np.full(dim, 1e-8), 1e-8
+    for _ in range(epochs):
+        logits = relevance_b + np.bincount(rows, weights=relevance_w[hashes], minlength=size) * scale
+        error = 1.0 / (1.0 + np.exp(-logits)) - labels
+        grad = np.bincount(hashes, weights=(error * scale)[rows], minlength=dim) + l2 * relevance_w
+        w_acc += grad ** 2
+        relevance_w -= learning_rate * grad / np.sqrt(w_acc)
+        b_grad = error.sum()
+        b_acc += b_grad ** 2
+        relevance_b -= learning_rate * b_grad / np.sqrt(b_acc)
+
+    # 상태 (관련 + 상태 라벨이 있는 예만)
+    statuses = list(statuses)
+    labelled = [i for i, example in enumerate(examples) if example['relevant'] and example.get('status') in statuses]
+    status_w = np.zeros((dim, len(statuses)))
+    status_b = np.zeros(len(statuses))
+    if labelled:
+        target = np.zeros((size, len(statuses)))
+        for i in labelled:
+            target[i, statuses.index(examples[i]['status'])] = 1.0
+        mask = np.zeros(size)
+        mask[labelled] = 1.0
+        w_acc, b_acc = np.full((dim, len(statuses)), 1e-8), np.full(len(statuses), 1e-8)
+        for _ in range(epochs):
+            probs = _softmax(_class_logits(status_w, status_b, hashes, rows, scale, size))
+            error = (probs - target) * mask[:, None]
+            weighted = (error * scale[:, None])[rows]
+            grad = np.stack([np.bincount(hashes, weights=weighted[:, k], minlength=dim)
+                             for k in range(len(statuses))], axis=1) + l2 * status_w
+            w_acc += grad ** 2
+            status_w -= learning_rate * grad / np.sqrt(w_acc)
+            b_grad = error.sum(axis=0)
+            b_acc += b_grad ** 2
+            status_b -= learning_rate * b_grad / np.sqrt(b_acc)
+
+    return RelevanceModel(relevance_w.astype(np.float32), relevance_b, status_w.astype(np.float32),
+                          status_b.astype(np.float32), statuses)
+
+
+def _class_logits(weights, bias, hashes, rows, scale, size):
+    gathered = weights[hashes]
+    logits = np.stack([np.bincount(rows, weights=gathered[:, k], minlength=size)
+                       for k in range(weights.shape[1])], axis=1)
+    return logits * scale[:, None] + bias
+
+
+def _softmax(logits):
+    logits = logits - logits.max(axis=1, keepdims=True)
+    probs = np.exp(logits)
+    return probs / probs.sum(axis=1, keepdims=True)
+
+
+def load_training_examples(config_dir: str) -> List[Dict]:
+    """설정 디렉토리의 학습 데이터 (저장된 세미나는 분류기 자신의 판정 결과이므로 사용하지 않음)"""
+    with open(os.path.join(config_dir, TRAINING_FILE), encoding='utf-8') as f:
+        return list(json.load(f)['examples'])
+
+
+class SeminarClassifier:
+    """키워드 매처 + 학습 모델 결합 판정 (모델은 키워드가 놓친 후보만 보완)"""
+
+    def __init__(self, model_path: Optional[str] = None):
+        self.model_path = model_path or os.getenv('RELEVANCE_MODEL_PATH', DEFAULT_MODEL_PATH)
+        self.threshold = float(os.getenv('RELEVANCE_THRESHOLD', '0.8'))
+        self.status_threshold = float(os.getenv('STATUS_CONFIDENCE_THRESHOLD', '0.6'))
+        self.model: Optional[RelevanceModel] = None
+        self._model_mtime = None
+
+    def load(self):
+        """모델 파일이 있으면 로드 (없으면 키워드 판정만, 기동 시 학습하지 않음)"""
+        if np is None:
+            logger.info("numpyが利用できないため関連度モデルは無効です (キーワード判定のみ)")
+            return
+        if not os.path.exists(self.model_path):
+            logger.info(f"関連度モデルがありません (キーワード判定のみ、`python relevance_model.py train` で作成): {self.model_path}")
+            return
+        try:
+            self.model = RelevanceModel.load(self.model_path)
+            self._model_mtime = os.stat(self.model_path).st_mtime_ns
+        except Exception as e:
+            self.model = None
+            logger.warning(f"関連度モデルを利用できません (キーワード判定のみ): {str(e)}")
+
+    def reload_if_changed(self) -> bool:
+        """`relevance_model.py train`으로 모델 파일이 갱신되면 교체 (실행 사이에만 호출)"""
+        if np is None:
+            return False
+        try:
+            mtime = os.stat(self.model_path).st_mtime_ns
+        except OSError:
+            return False
+        if mtime == self._model_mtime:
+            return False
+        try:
+            self.model = RelevanceModel.load(self.model_path)
+        except Exception as e:
+            logger.error(f"関連度モデル再読込エラー (現行モデルを継続): {str(e)}")
+            return False
+        self._model_mtime = mtime
+        logger.info(f"関連度モデルを再読込しました: {self.model_path}")
+        return True
+
+    def classify(self, texts: Sequence[str], config) -> List[Tuple[bool, str]]:
+        """후보 텍스트 일괄 판정 → [(세미나 관련 여부, 상태)]"""
+        keyword_hits = [config.seminar_pattern.search(text) is not None for text in texts]
+        keyword_statuses = [next((status for keyword, status in config.status_rules if keyword in text), None)
+                            for text in texts]
+
+        if self.model is None or not texts:
+            return [(hit, status or DEFAULT_STATUS) for hit, status in zip(keyword_hits, keyword_statuses)]
+
+        relevance, statuses, confidence = self.model.predict(texts)
+        results = []
+        for i in range(len(texts)):
+            relevant = keyword_hits[i] or (bool(texts[i].strip()) and bool(relevance[i] >= self.threshold))
+            status = keyword_statuses[i]
+            if status is None:
+                status = statuses[i] if confidence[i] >= self.status_threshold else DEFAULT_STATUS
+            results.append((relevant, status))
+        return results
+
+
+def main():
+    logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
+
+    parser = argparse.ArgumentParser(description='セミナー関連度・ステータス分類モデル')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    train_parser = subparsers.add_parser('train', help='学習データ (config/relevance_training.json) から再学習')
+    train_parser.add_argument('--epochs', type=int, default=300)
+
+    subparsers.add_parser('score', help='標準入力の各行を判定')
+
+    args = parser.parse_args()
+    config_dir = os.getenv('CONFIG_DIR', '/app/config')
+    model_path = os.getenv('RELEVANCE_MODEL_PATH', DEFAULT_MODEL_PATH)
+
+    if np is None:
+        print("numpyが必要です", file=sys.stderr)
+        sys.exit(1)
+
+    if args.command == 'train':
+        from seminar_config import VALID_STATUSES
+        examples = load_training_examples(config_dir)
+        model = train(examples, sorted(VALID_STATUSES), epochs=args.epochs)
+        model.save(model_path)
+        relevance, _, _ = model.predict([example['text'] for example in examples])
+        accuracy = np.mean((relevance >= 0.5) == np.array([bool(example['relevant']) for example in examples]))
+        print(f"学習完了: {len(examples)}件, 学習データ正解率 {accuracy:.1%} → {model_path}")
+    elif args.command == 'score':
+        model = RelevanceModel.load(model_path)
+        texts = [line.strip() for line in sys.stdin if line.strip()]
+        for text, score, status, confidence in zip(texts, *model.predict(texts)):
+            print(f"{score:.3f}\t{status}({confidence:.2f})\t{text}")
+
+
+if __name__ == "__main__":
+    main()
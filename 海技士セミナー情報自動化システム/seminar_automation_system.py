@@ -7,21 +7,30 @@ Date: 2025-09-26
 """
 
 import sqlite3
-import requests
 import feedparser
 from bs4 import BeautifulSoup
 from datetime import datetime, timedelta
 import hashlib
 import logging
-import smtplib
-from email.mime.text import MIMEText
-from email.mime.multipart import MIMEMultipart
-import re
 import time
 import os
-import json
-from typing import List, Dict, Optional, Tuple
+from urllib.parse import urljoin
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, List, Dict, Optional, Tuple
 import pytz
+from memory_monitor import MemoryMonitor
+from tracing import Tracer
+from seminar_config import SeminarConfig, ConfigWatcher
+from snapshot_diff import SnapshotStore, Validators, fingerprint
+from change_detection import ChangeDetector
+from gazetteer import GridIndex
+from ics_feed import CalendarFeeds, render_vevent
+from runtime import Runtime
+from slack_threads import SlackThreads
+from webhooks import WebhookOutbox
+from alerting import AlertEngine
+import extraction
+import clock
 
 # ログ設定
 logging.basicConfig(
@@ -38,43 +47,111 @@ logger = logging.getLogger(__name__)
 JST = pytz.timezone('Asia/Tokyo')
 
 class SeminarAutomationSystem:
-    def __init__(self, db_path: str = '/app/data/seminar_automation.db'):
-        self.db_path = db_path
+    def __init__(self, db_path: str = None, config_dir: str = None, runtime: Runtime = None, tenant: str = None):
+        """runtime 생략 시 프로세스 공통 컨텍스트 (DB・설정 디렉터리 기본값, HTTP 취득・발송 풀・관련도 모델 공유)"""
+        self.runtime = runtime or Runtime.current()
+        self.db_path = db_path or self.runtime.settings.db_path
+        self.tenant = tenant
         self.setup_database()
+
+        # 메모리 예산 관리 (컨테이너 메모리 제한 대응, 예산・압박 판정은 프로세스 공통)
+        self.memory = MemoryMonitor(self.runtime.memory)
+        self.process_batch_size = int(os.getenv('PROCESS_BATCH_SIZE', '50'))
+
+        # 항목별 트레이싱 (수집 → 발송)
+        self.tracer = Tracer()
+
+        # HTTP 취득 (프로세스 공통 커넥션 풀, 실행 내 동일 URL은 1회만 취득)
+        self.fetcher = self.runtime.fetcher
+        self.fetch_workers = int(os.getenv('FETCH_WORKERS', '8'))
+        # 섀도 모드의 재생용 취득 결과 (end_run 후에는 다른 테넌트의 begin_run 이 결과를 비울 수 있으므로 그 전에 보관)
+        self.record_fetches = False
+        self.recorded_fetches = None
+
+        # 발송 계층 (프로세스 공통 SMTP 연결 풀・Slack 세션)
+        self.smtp = self.runtime.smtp
+        self.slack = self.runtime.slack
+        # Slack 채널 모드 (지역・일자별 부모 메시지에 스레드 답글 / 제자리 갱신, SLACK_MODE)
+        self.slack_threads = SlackThreads.from_env(lambda: self.runtime.connect(self.db_path), lambda: self.slack)
+        # 발신 Webhook (실행 중 발송을 엔드포인트별로 모아 실행 끝에 서명된 JSON 일괄 POST)
+        self.webhook = self.runtime.webhook
+        self.webhooks = WebhookOutbox(lambda: self.webhook, tenant)
+        # 대기열에 넣은 발송 (경로, 항목 트레이스), 실행 끝의 일괄 발송 결과로 성공・실패 확정
+        self.queued_deliveries: List[Tuple[Dict, List]] = []
+
+        # 채널별・정보원별 실패율 알림 (메모리 내 슬라이딩 윈도우)
+        self.alerts = AlertEngine(self.ops_alert_sinks())
+
+        # 정보원별 항목 스냅샷 (변경분만 처리)
+        self.snapshots = SnapshotStore(lambda: self.runtime.connect(self.db_path))
+
+        # sitemap lastmod・조건부 GET으로 변경 없는 페이지의 본문 취득을 생략
+        self.change_detector = ChangeDetector(self.fetcher, self.snapshots)
         
-        # セミナー関連キーワード定義
-        self.seminar_keywords = [
-            '海技士セミナー', '海事セミナー', 'めざせ！海技者', '船員就職',
-            '海技者', '船員セミナー', '海運セミナー', '海事講習',
-            '船員養成', '海技免許', '海技資格'
-        ]
-        
-        # ステータスキーワード定義
-        self.status_keywords = {
-            '募集開始': '募集中',
-            '募集中': '募集中',
-            '受付開始': '募集中',
-            '申込開始': '募集中',
-            '満員': '募集締切',
-            '定員満了': '募集締切',
-            '締切': '募集締切',
-            '受付終了': '募集締切',
-            '申込終了': '募集締切',
-            '開催予定': '開催予定',
-            '開催中': '開催予定',
-            '終了': '開催終了',
-            '開催終了': '開催終了',
-            '中止': '中止',
-            '延期': 'その他'
-        }
-        
-        # 地方運輸局情報読み込み
-        self.load_transport_bureaus()
+        # 설정 로드 (지방운수국 목록・키워드 테이블, 변경 시 실행 사이에 교체)
+        self.config_dir = config_dir or self.runtime.settings.config_dir
+        self.config = SeminarConfig.load(self.config_dir)
+        self.config_watcher = ConfigWatcher(self.config_dir)
+        logger.info(f"地方運輸局情報読込完了: {len(self.transport_bureaus)}機関")
+
+        # 키워드가 놓친 표기 변형을 보완하는 문자 n-gram 분류기 (페이지 단위 일괄 추론)
+        self.classifier = self.runtime.classifier(self.config_dir, self.db_path, tenant)
+
+        # 구독자별 iCalendar 피드 (세미나별 VEVENT 조각을 저장 시 1회 렌더링)
+        self.calendar = CalendarFeeds(lambda: self.runtime.connect(self.db_path), lambda: self.config.gazetteer)
+
+    def ops_alert_sinks(self) -> List[Tuple[str, Callable[[str, str], bool]]]:
+        """운영 알림 수신처 (OPS_EMAIL, OPS_SLACK)"""
+        sinks = []
+        ops_email = os.getenv('OPS_EMAIL')
+        if ops_email:
+            sinks.append(('email', lambda subject, body: self.smtp.send(
+                ops_email, subject, body.replace('\n', '<br>'), body)))
+        ops_slack = os.getenv('OPS_SLACK')
+        if ops_slack:
+            sinks.append(('slack', lambda subject, body: self.slack.send(ops_slack, f"*{subject}*\n{body}")[0]))
+        return sinks
+
+    @property
+    def transport_bureaus(self) -> Dict:
+        return self.config.transport_bureaus
+
+    @property
+    def seminar_keywords(self) -> List[str]:
+        return self.config.seminar_keywords
+
+    @property
+    def status_keywords(self) -> Dict[str, str]:
+        return self.config.status_keywords
+
+    def reload_config_if_changed(self) -> bool:
+        """설정 변경 시 재컴파일 후 원자적으로 교체 (실행 사이에만 호출)"""
+        self.classifier.reload_if_changed()
+
+        if not self.config_watcher.changed():
+            return False
+
+        try:
+            new_config = SeminarConfig.load(self.config_dir, reload=True)
+        except Exception as e:
+            logger.error(f"設定再読込エラー (現行設定を継続): {str(e)}")
+            return False
+
+        if new_config.fingerprint == self.config.fingerprint:
+            return False
+
+        self.config = new_config
+        logger.info(f"設定を再読込しました: {len(self.transport_bureaus)}機関, "
+                    f"セミナーキーワード{len(self.seminar_keywords)}件, ステータスキーワード{len(self.status_keywords)}件")
+        return True
 
     def setup_database(self):
         """データベース初期化"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
+        self.migrate_channel_checks(cursor)
+        backfill_regions = cursor.execute(
+            "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'seminar_regions'").fetchone() is None
         
         # テーブル作成
         cursor.executescript('''
@@ -108,6 +185,13 @@ class SeminarAutomationSystem:
                 updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
             );
             
+            -- 여러 지역이 공유하는 항목은 1건만 저장하고 대상 지역은 여기서 관리
+            CREATE TABLE IF NOT EXISTS seminar_regions (
+                seminar_id INTEGER NOT NULL REFERENCES seminars(seminar_id),
+                region_id INTEGER NOT NULL REFERENCES regions(region_id),
+                PRIMARY KEY (seminar_id, region_id)
+            ) WITHOUT ROWID;
+            
             CREATE TABLE IF NOT EXISTS subscribers (
                 subscriber_id INTEGER PRIMARY KEY AUTOINCREMENT,
                 name VARCHAR(100) NOT NULL,
@@ -117,19 +201,86 @@ class SeminarAutomationSystem:
             CREATE TABLE IF NOT EXISTS subscriber_routing (
                 routing_id INTEGER PRIMARY KEY AUTOINCREMENT,
                 subscriber_id INTEGER REFERENCES subscribers(subscriber_id),
-                channel VARCHAR(20) NOT NULL CHECK (channel IN ('email', 'slack')),
+                channel VARCHAR(20) NOT NULL CHECK (channel IN ('email', 'slack', 'webhook')),
                 address VARCHAR(255) NOT NULL
             );
             
             CREATE TABLE IF NOT EXISTS seminar_notifications (
                 notification_id INTEGER PRIMARY KEY AUTOINCREMENT,
                 seminar_id INTEGER REFERENCES seminars(seminar_id),
-                channel VARCHAR(20) NOT NULL CHECK (channel IN ('email', 'slack')),
+                channel VARCHAR(20) NOT NULL CHECK (channel IN ('email', 'slack', 'webhook')),
                 address VARCHAR(255) NOT NULL,
                 status VARCHAR(10) NOT NULL CHECK (status IN ('ok', 'fail')),
                 sent_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
                 error TEXT
             );
+
+            CREATE TABLE IF NOT EXISTS source_snapshots (
+                url VARCHAR(255) PRIMARY KEY,
+                config_fingerprint VARCHAR(64) NOT NULL,
+                item_count INTEGER NOT NULL DEFAULT 0,
+                updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE TABLE IF NOT EXISTS source_items (
+                url VARCHAR(255) NOT NULL,
+                item_key VARCHAR(255) NOT NULL,
+                fingerprint VARCHAR(40) NOT NULL,
+                PRIMARY KEY (url, item_key)
+            );
+
+            CREATE TABLE IF NOT EXISTS seminar_venues (
+                seminar_id INTEGER PRIMARY KEY REFERENCES seminars(seminar_id),
+                place VARCHAR(100) NOT NULL,
+                latitude REAL NOT NULL,
+                longitude REAL NOT NULL
+            );
+
+            CREATE TABLE IF NOT EXISTS subscriber_proximity (
+                proximity_id INTEGER PRIMARY KEY AUTOINCREMENT,
+                subscriber_id INTEGER REFERENCES subscribers(subscriber_id),
+                place VARCHAR(100) NOT NULL,
+                radius_km REAL NOT NULL CHECK (radius_km > 0)
+            );
+
+            CREATE TABLE IF NOT EXISTS seminar_vevents (
+                seminar_id INTEGER PRIMARY KEY REFERENCES seminars(seminar_id),
+                fragment TEXT NOT NULL,
+                fragment_hash VARCHAR(40) NOT NULL,
+                rendered_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE TABLE IF NOT EXISTS subscriber_calendars (
+                subscriber_id INTEGER PRIMARY KEY REFERENCES subscribers(subscriber_id),
+                token VARCHAR(64) UNIQUE NOT NULL,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            );
+
+            CREATE TABLE IF NOT EXISTS source_validators (
+                url VARCHAR(255) PRIMARY KEY,
+                etag VARCHAR(255),
+                last_modified VARCHAR(64),
+                lastmod VARCHAR(64)
+            );
+
+            CREATE TABLE IF NOT EXISTS slack_threads (
+                channel VARCHAR(255) NOT NULL,
+                topic VARCHAR(100) NOT NULL,
+                day DATE NOT NULL,
+                channel_id VARCHAR(32),
+                ts VARCHAR(32) NOT NULL,
+                items TEXT NOT NULL,
+                updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+                PRIMARY KEY (channel, topic, day)
+            );
+
+            -- 수 년 분량 이력에서도 전체 스캔이 되지 않도록 (storage_benchmark.py 로 확인)
+            CREATE INDEX IF NOT EXISTS idx_seminars_created_at ON seminars(created_at);
+            CREATE INDEX IF NOT EXISTS idx_seminars_region_created_at ON seminars(region_id, created_at);
+            CREATE INDEX IF NOT EXISTS idx_seminars_region_event_date ON seminars(region_id, event_date);
+            CREATE INDEX IF NOT EXISTS idx_seminar_regions_region ON seminar_regions(region_id, seminar_id);
+            CREATE INDEX IF NOT EXISTS idx_subscribers_region ON subscribers(region_id);
+            CREATE INDEX IF NOT EXISTS idx_subscriber_routing_subscriber ON subscriber_routing(subscriber_id);
         ''')
         
         # 초기 데이터 투입
@@ -138,65 +289,72 @@ class SeminarAutomationSystem:
             ('근기',), ('고베',), ('중국',), ('사국',), ('구주',)
         ]
         cursor.executemany('INSERT OR IGNORE INTO regions (name) VALUES (?)', regions_data)
+
+        if backfill_regions:
+            # 기존 DB: 세미나별 단일 지역을 대상 지역 테이블로 이관
+            cursor.execute('''
+                INSERT OR IGNORE INTO seminar_regions (seminar_id, region_id)
+                SELECT seminar_id, region_id FROM seminars WHERE region_id IS NOT NULL
+            ''')
         
         conn.commit()
         conn.close()
         logger.info("データベース初期化が完了しました")
 
-    def load_transport_bureaus(self):
-        """지방운수국 정보 로드"""
-        try:
-            with open('/app/regional_transport_bureaus.json', 'r', encoding='utf-8') as f:
-                bureaus_data = json.load(f)
-            
-            self.transport_bureaus = {}
-            region_mapping = {
-                '北海道運輸局': '북해도',
-                '東北運輸局': '동북',
-                '関東運輸局': '관동',
-                '北陸信越運輸局': '북륙신월',
-                '中部運輸局': '중부',
-                '近畿運輸局': '근기',
-                '神戸運輸監理部': '고베',
-                '中国運輸局': '중국',
-                '四国運輸局': '사국',
-                '九州運輸局': '구주'
-            }
-            
-            for bureau in bureaus_data:
-                if bureau['name'] in region_mapping:
-                    region_name = region_mapping[bureau['name']]
-                    self.transport_bureaus[region_name] = {
-                        'name': bureau['name'],
-                        'url': bureau['url'],
-                        'type': 'html'  # 기본값, RSS 확인 후 변경 가능
-                    }
-            
-            logger.info(f"地方運輸局情報読込完了: {len(self.transport_bureaus)}機関")
-            
-        except FileNotFoundError:
-            logger.error("地方運輸局情報ファイルが見つかりません")
-            self.transport_bureaus = {}
+    def migrate_channel_checks(self, cursor: sqlite3.Cursor):
+        """기존 DB 의 channel CHECK 제약에 'webhook' 추가 (SQLite 는 제약 변경 불가 → 테이블 재작성)"""
+        for table in ('subscriber_routing', 'seminar_notifications'):
+            row = cursor.execute("SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?", (table,)).fetchone()
+            if not row or "'webhook'" in row[0]:
+                continue
+            sql = row[0].replace("CHECK (channel IN ('email', 'slack'))", "CHECK (channel IN ('email', 'slack', 'webhook'))")
+            # 인덱스는 이전 테이블과 함께 삭제되고 이어지는 CREATE INDEX IF NOT EXISTS 로 다시 작성됨
+            cursor.executescript(f'''
+                BEGIN;
+                ALTER TABLE {table} RENAME TO {table}_old;
+                {sql};
+                INSERT INTO {table} SELECT * FROM {table}_old;
+                DROP TABLE {table}_old;
+                COMMIT;
+            ''')
+            logger.info(f"DB移行: {table} のチャネルに webhook を追加")
 
     def collect_seminars_from_all_sources(self) -> List[Dict]:
-        """모든 정보원에서 세미나 정보 수집"""
+        """모든 정보원에서 세미나 정보 수집 (URL당 1회 취득・파싱 후 지역별로 분배)"""
         all_seminars = []
+        self.fetcher.begin_run()
+        self.change_detector.begin_run()
         
-        for region_name, bureau_info in self.transport_bureaus.items():
-            try:
-                logger.info(f"{region_name}地域のセミナー情報収集開始: {bureau_info['url']}")
-                
-                if bureau_info['type'] == 'rss':
-                    seminars = self.collect_from_rss(bureau_info, region_name)
-                else:
-                    seminars = self.collect_from_html(bureau_info, region_name)
-                
-                all_seminars.extend(seminars)
-                logger.info(f"{region_name}地域から{len(seminars)}件のセミナー情報を収集")
-                
-            except Exception as e:
-                logger.error(f"{region_name}地域情報収集中にエラー: {str(e)}")
-                continue
+        # 정보원별 취득・파싱을 병렬 실행 (호스트별 동시 요청 수는 Fetcher의 AIMD 상한이 제어, 메모리 압박 시 워커 수 축소)
+        workers = self.memory.scale(self.fetch_workers)
+        if workers < self.fetch_workers:
+            logger.warning(f"メモリ逼迫のため収集ワーカー数を{self.fetch_workers}→{workers}に縮小します")
+        with ThreadPoolExecutor(max_workers=workers, thread_name_prefix='collect') as executor:
+            futures = [(url, source, executor.submit(self.collect_source_within_budget, url, source))
+                       for url, source in self.config.sources.items()]
+
+            # 결과는 정보원 정의 순서로 지역에 분배
+            for url, source, future in futures:
+                try:
+                    candidates = future.result()
+                    if candidates is None:
+                        continue
+
+                    seminars = self.assign_to_regions(candidates, source)
+                    all_seminars.extend(seminars)
+                    for region_name in source['regions']:
+                        count = sum(region_name in seminar['regions'] for seminar in seminars)
+                        logger.info(f"{region_name}地域から{count}件のセミナー情報を収集 ({url})")
+
+                except Exception as e:
+                    logger.error(f"{', '.join(source['regions'])}地域情報収集中にエラー ({url}): {str(e)}")
+                    continue
+
+        self.fetcher.log_stats()
+        if self.record_fetches:
+            self.recorded_fetches = self.fetcher.recorded()
+        self.fetcher.end_run()
+        self.change_detector.log_stats()
 
         # 過去イベントを除外し、未来イベントのみ返す
         future_seminars = self.filter_future_seminars(all_seminars)
@@ -204,160 +362,212 @@ class SeminarAutomationSystem:
 
         return future_seminars
 
-    def collect_from_rss(self, bureau_info: Dict, region_name: str) -> List[Dict]:
+    def collect_source_within_budget(self, url: str, source: Dict) -> Optional[List[Dict]]:
+        """정보원 1건 수집 (메모리 예산 초과로 연기한 경우 None)"""
+        # 메모리 예산 초과 시 회수 후에도 초과하면 남은 수집은 다음 실행으로 연기
+        if self.memory.over_budget():
+            self.memory.relieve()
+            if self.memory.over_budget():
+                logger.warning(f"メモリ予算超過のため{url}の収集を次回に延期します")
+                return None
+
+        logger.info(f"セミナー情報収集開始: {url} (対象地域: {', '.join(source['regions'])})")
+        # 파싱 결과는 테넌트의 설정・스냅샷에 의존하므로 테넌트 내에서만 공유
+        return self.fetcher.flight.do(('parse', self.tenant, url), lambda: self.collect_from_source(source))
+
+    def collect_from_source(self, source: Dict) -> List[Dict]:
+        """정보원 1건 취득・파싱 (지역 무관한 후보 목록)"""
+        if source['type'] == 'rss':
+            return self.collect_from_rss(source['url'], source.get('sitemap_url'))
+        return self.collect_from_html(source['url'], source.get('sitemap_url'))
+
+    def assign_to_regions(self, candidates: List[Dict], source: Dict) -> List[Dict]:
+        """후보별 대상 지역 결정 (여러 지역이 공유하는 페이지는 지역 키워드로 필터링, 항목은 1건으로 저장)"""
+        regions = source['regions']
+        assigned = []
+
+        for candidate in candidates:
+            targets = regions
+            if len(regions) > 1:
+                # 지역명이 언급된 항목은 해당 지역에만, 언급이 없으면 전국 대상으로 모든 지역에
+                text = f"{candidate['title']} {candidate['raw_text']}"
+                matched = [region_name for region_name in regions
+                           if self.transport_bureaus[region_name]['area_pattern'] is not None
+                           and self.transport_bureaus[region_name]['area_pattern'].search(text)]
+                targets = matched or regions
+
+            seminar = {key: value for key, value in candidate.items() if key != 'spans'}
+            seminar['region'] = targets[0]
+            seminar['regions'] = list(targets)
+            trace = self.tracer.start_trace(seminar['source_url'], region=', '.join(targets), source=source['url'])
+            for span in candidate['spans']:
+                trace.add_span(*span)
+            seminar['trace'] = trace
+            assigned.append(seminar)
+
+        return assigned
+
+    def collect_from_rss(self, url: str, sitemap_url: str = None) -> List[Dict]:
         """RSS 피드에서 세미나 정보 수집"""
-        seminars = []
+        candidates = []
         
         try:
-            feed = feedparser.parse(bureau_info['url'])
+            check = self.change_detector.check(url, self.config.fingerprint, sitemap_url)
+            if check.skip:
+                return candidates
+
+            # HTML과 같은 취득 계층을 거쳐 호스트별 동시성 제어를 적용
+            page = self.fetcher.get(url, headers=check.headers)
+            self.alerts.record('source', url, True)
+            if page.not_modified:
+                self.change_detector.mark_not_modified(url, check)
+                return candidates
+            feed = feedparser.parse(page.content)
+            fetch_span = ('fetch', page.started_ns, page.ended_ns, {'url': url, 'entries': len(feed.entries)})
+
+            # 이전 실행 대비 추가・변경된 항목만 하류로 전달
+            delta = self.snapshots.diff(
+                url, {entry.link: fingerprint(f"{entry.title}\n{entry.get('published', entry.get('updated', ''))}")
+                      for entry in feed.entries}, self.config.fingerprint,
+                validators=Validators(self.config.fingerprint, page.etag, page.last_modified, check.lastmod))
+            logger.info(f"フィード差分 ({url}): {delta}")
+            delta_keys = delta.keys
+            entries = [entry for entry in feed.entries if entry.link in delta_keys]
+
+            # 세미나 관련도・상태를 피드 단위로 일괄 판정
+            classify_started = time.time_ns()
+            verdicts = self.classify_titles([entry.title for entry in entries])
+            classify_ended = time.time_ns()
             
-            for entry in feed.entries:
-                title = entry.title
-                
-                # 세미나 키워드 필터링
-                if not self.contains_seminar_keywords(title):
+            for entry, (relevant, status) in zip(entries, verdicts):
+                if not relevant:
                     continue
+
+                title = entry.title
                 
-                seminar = {
-                    'region': region_name,
+                candidate = {
                     'title': title,
                     'event_date': self.parse_date(entry.published if hasattr(entry, 'published') else entry.updated),
                     'location': self.extract_location(title),
-                    'status': self.detect_status(title),
+                    'status': status,
                     'source_url': entry.link,
                     'raw_text': entry.summary if hasattr(entry, 'summary') else title
                 }
-                seminars.append(seminar)
+                candidate['spans'] = [
+                    fetch_span,
+                    ('classify', classify_started, classify_ended, {'status': status, 'batch': len(entries)})
+                ]
+                candidates.append(candidate)
                 
         except Exception as e:
-            logger.error(f"RSS 수집 오류 ({bureau_info['url']}): {str(e)}")
+            self.alerts.record('source', url, False)
+            logger.error(f"RSS 수집 오류 ({url}): {str(e)}")
             
-        return seminars
+        return candidates
 
-    def collect_from_html(self, bureau_info: Dict, region_name: str) -> List[Dict]:
+    def collect_from_html(self, url: str, sitemap_url: str = None) -> List[Dict]:
         """HTML 페이지에서 세미나 정보 수집"""
-        seminars = []
+        candidates = []
         
         try:
-            response = requests.get(bureau_info['url'], timeout=30)
-            response.raise_for_status()
-            soup = BeautifulSoup(response.content, 'html.parser')
+            # 색인 문서에서 변경이 없다고 판정되면 본문을 취득하지 않음
+            check = self.change_detector.check(url, self.config.fingerprint, sitemap_url)
+            if check.skip:
+                return candidates
+
+            page = self.fetcher.get(url, headers=check.headers)
+            self.alerts.record('source', url, True)
+            if page.not_modified:
+                self.change_detector.mark_not_modified(url, check)
+                return candidates
+            fetch_span = ('fetch', page.started_ns, page.ended_ns,
+                          {'url': url, 'http_status': page.status_code, 'bytes': len(page.content)})
+
+            parse_started = time.time_ns()
+            soup = BeautifulSoup(page.content, 'html.parser')
             
-            # 세미나 관련 링크 찾기
+            # 세미나 관련 링크 찾기 (절대 URL별로 앵커 텍스트를 묶음)
             links = soup.find_all('a', href=True)
-            
+            anchors = {}
             for link in links:
-                title = link.get_text(strip=True)
-                
-                # 세미나 키워드 필터링
-                if not self.contains_seminar_keywords(title):
-                    continue
-                
                 href = link.get('href')
                 if href:
                     # 상대 URL을 절대 URL로 변환
-                    if href.startswith('/'):
-                        source_url = bureau_info['url'].rstrip('/') + href
-                    elif href.startswith('http'):
-                        source_url = href
-                    else:
-                        source_url = bureau_info['url'].rstrip('/') + '/' + href
-                    
-                    seminar = {
-                        'region': region_name,
-                        'title': title,
-                        'event_date': self.extract_date_from_text(title),
-                        'location': self.extract_location(title),
-                        'status': self.detect_status(title),
-                        'source_url': source_url,
-                        'raw_text': title
-                    }
-                    seminars.append(seminar)
+                    anchors.setdefault(urljoin(url, href), []).append(link.get_text(strip=True))
+
+            # 이전 실행 대비 추가・변경된 항목만 하류로 전달
+            delta = self.snapshots.diff(
+                url, {key: fingerprint('\n'.join(titles)) for key, titles in anchors.items()}, self.config.fingerprint,
+                validators=Validators(self.config.fingerprint, page.etag, page.last_modified, check.lastmod))
+            logger.info(f"ページ差分 ({url}): {delta}")
+            parse_span = ('parse', parse_started, time.time_ns(),
+                          {'anchors': len(links), 'added': len(delta.added), 'changed': len(delta.changed)})
+
+            delta_keys = delta.keys
+            pending = [(source_url, title) for source_url, titles in anchors.items() if source_url in delta_keys
+                       for title in titles]
+
+            # 세미나 관련도・상태를 페이지 단위로 일괄 판정
+            classify_started = time.time_ns()
+            verdicts = self.classify_titles([title for _, title in pending])
+            classify_ended = time.time_ns()
+
+            for (source_url, title), (relevant, status) in zip(pending, verdicts):
+                if not relevant:
+                    continue
+
+                candidate = {
+                    'title': title,
+                    'event_date': self.extract_date_from_text(title),
+                    'location': self.extract_location(title),
+                    'status': status,
+                    'source_url': source_url,
+                    'raw_text': title
+                }
+                candidate['spans'] = [
+                    fetch_span,
+                    parse_span,
+                    ('classify', classify_started, classify_ended, {'status': status, 'batch': len(pending)})
+                ]
+                candidates.append(candidate)
+
+            # 파싱 트리를 즉시 해제
+            soup.decompose()
                     
         except Exception as e:
-            logger.error(f"HTML 수집 오류 ({bureau_info['url']}): {str(e)}")
+            self.alerts.record('source', url, False)
+            logger.error(f"HTML 수집 오류 ({url}): {str(e)}")
             
-        return seminars
+        return candidates
+
+    def classify_titles(self, titles: List[str]) -> List[Tuple[bool, str]]:
+        """후보 제목 일괄 판정 → [(세미나 관련 여부, 상태)] (모델 미사용 시 키워드만)"""
+        return self.classifier.classify(titles, self.config)
 
     def contains_seminar_keywords(self, text: str) -> bool:
         """텍스트에 세미나 키워드가 포함되어 있는지 확인"""
-        text_lower = text.lower()
-        for keyword in self.seminar_keywords:
-            if keyword.lower() in text_lower:
-                return True
-        return False
+        return extraction.contains_keywords(self.config.seminar_pattern, text)
 
     def detect_status(self, text: str) -> str:
         """텍스트에서 세미나 상태 감지"""
-        for keyword, status in self.status_keywords.items():
-            if keyword in text:
-                return status
-        return '募集中'  # デフォルト値
+        return extraction.detect_status(text, self.config.status_rules)
 
     def extract_location(self, text: str) -> Optional[str]:
         """텍스트에서 장소 정보 추출"""
-        # 간단한 장소 추출 로직 (개선 가능)
-        location_patterns = [
-            r'(東京|大阪|神戸|福岡|仙台|札幌|名古屋|広島|高松|那覇)',
-            r'(会議室|ホール|センター|ビル|会館)',
-            r'IN\s+([A-Z]+)',
-            r'in\s+([^\s]+)'
-        ]
-        
-        for pattern in location_patterns:
-            match = re.search(pattern, text)
-            if match:
-                return match.group(1) if match.group(1) else match.group(0)
-        
-        return None
+        return extraction.extract_location(text, self.config.gazetteer)
 
     def extract_date_from_text(self, text: str) -> Optional[datetime]:
         """텍스트에서 날짜 정보 추출"""
-        # 일본 날짜 형식 패턴
-        date_patterns = [
-            r'令和(\d+)年(\d+)月(\d+)日',
-            r'(\d{4})年(\d{1,2})月(\d{1,2})日',
-            r'(\d{1,2})月(\d{1,2})日',
-            r'(\d{4})/(\d{1,2})/(\d{1,2})',
-            r'(\d{4})-(\d{1,2})-(\d{1,2})'
-        ]
-        
-        for pattern in date_patterns:
-            match = re.search(pattern, text)
-            if match:
-                try:
-                    if '令和' in pattern:
-                        # 령화 연호를 서기로 변환 (령화 1년 = 2019년)
-                        reiwa_year = int(match.group(1))
-                        year = 2018 + reiwa_year
-                        month = int(match.group(2))
-                        day = int(match.group(3))
-                    elif len(match.groups()) == 3:
-                        year = int(match.group(1))
-                        month = int(match.group(2))
-                        day = int(match.group(3))
-                        if year < 100:  # 2자리 연도 처리
-                            year += 2000
-                    elif len(match.groups()) == 2:
-                        # 월/일만 있는 경우 현재 연도 사용
-                        year = datetime.now().year
-                        month = int(match.group(1))
-                        day = int(match.group(2))
-                    else:
-                        continue
-                    
-                    return JST.localize(datetime(year, month, day))
-                except ValueError:
-                    continue
-        
-        return None
+        # 월/일만 있는 경우 현재 연도 사용
+        date = extraction.extract_date(text, clock.now().year)
+        return JST.localize(date) if date else None
 
     def is_future_event(self, event_date: Optional[datetime]) -> bool:
         """이벤트가 미래 이벤트인지 확인 (오늘 포함)"""
         if not event_date:
             return True  # 날짜 불명인 경우 포함
 
-        current_time = datetime.now(JST)
+        current_time = clock.now(JST)
         today = current_time.replace(hour=0, minute=0, second=0, microsecond=0)
 
         # 오늘 이후의 이벤트만 포함
@@ -383,13 +593,15 @@ class SeminarAutomationSystem:
                 logger.info(f"未来イベント含む: {seminar.get('title', 'N/A')} - {event_date}")
             else:
                 logger.info(f"過去イベント除外: {seminar.get('title', 'N/A')} - {event_date}")
+                if seminar.get('trace'):
+                    seminar['trace'].finish('dropped:past_event')
 
         return future_seminars
 
     def get_recent_seminars(self, limit: int = 1) -> List[Dict]:
         """最近のセミナー情報を取得"""
         try:
-            conn = sqlite3.connect(self.db_path)
+            conn = self.runtime.connect(self.db_path)
             cursor = conn.cursor()
 
             # 最近作成されたセミナー情報を取得
@@ -437,7 +649,7 @@ class SeminarAutomationSystem:
     def create_no_new_info_summary(self, recent_seminars: List[Dict]) -> str:
         """新しい情報がない場合のメール内容を作成"""
         try:
-            current_date = datetime.now(JST).strftime('%Y年%m月%d日')
+            current_date = clock.now(JST).strftime('%Y年%m月%d日')
 
             html_content = f"""
             <html>
@@ -505,7 +717,7 @@ class SeminarAutomationSystem:
                     <div class="footer">
                         <p>このメールは海技士セミナー情報自動配信システムより送信されました。</p>
                         <p>次回配信: 明日 09:00 JST</p>
-                        <p>配信時刻: {datetime.now(JST).strftime('%Y年%m月%d日 %H:%M:%S JST')}</p>
+                        <p>配信時刻: {clock.now(JST).strftime('%Y年%m月%d日 %H:%M:%S JST')}</p>
                     </div>
                 </div>
             </body>
@@ -518,97 +730,47 @@ class SeminarAutomationSystem:
             return f"<html><body><h2>海技士セミナー情報 - {current_date}</h2><p>本日は新しい情報がありませんでした。</p></body></html>"
 
     def send_html_email(self, to_email: str, subject: str, html_content: str, text_content: str = None) -> bool:
-        """HTML 이메일 발송"""
-        try:
-            # SMTP 설정을 환경변수에서 읽기
-            smtp_server = os.getenv('SMTP_SERVER', 'smtp.gmail.com')
-            smtp_port = int(os.getenv('SMTP_PORT', '587'))
-            smtp_username = os.getenv('SMTP_USERNAME')
-            smtp_password = os.getenv('SMTP_PASSWORD')
-            from_email = os.getenv('FROM_EMAIL', smtp_username)
-
-            if not smtp_username or not smtp_password:
-                logger.error("SMTP 인증 정보가 설정되지 않았습니다")
-                return False
-
-            # 이메일 메시지 생성
-            msg = MIMEMultipart('alternative')
-            msg['Subject'] = subject
-            msg['From'] = from_email
-            msg['To'] = to_email
-
-            # HTML과 텍스트 버전 추가
-            if text_content:
-                text_part = MIMEText(text_content, 'plain', 'utf-8')
-                msg.attach(text_part)
-
-            html_part = MIMEText(html_content, 'html', 'utf-8')
-            msg.attach(html_part)
-
-            # SMTP 서버 연결 및 발송
-            logger.info(f"SMTP 설정: {smtp_server}:{smtp_port}")
-            with smtplib.SMTP(smtp_server, smtp_port) as server:
-                server.starttls()
-                server.login(smtp_username, smtp_password)
-                server.send_message(msg)
-
-            logger.info(f"✅ 메일 발송 성공: {subject}")
-            return True
-
-        except Exception as e:
-            logger.error(f"메일 발송 실패: {str(e)}")
-            return False
+        """HTML 이메일 발송 (연결 풀 재사용)"""
+        return self.smtp.send(to_email, subject, html_content, text_content)
 
     def parse_date(self, date_str: str) -> datetime:
         """날짜 문자열을 datetime 객체로 변환"""
-        try:
-            # 복수의 날짜 형식에 대응
-            formats = [
-                '%a, %d %b %Y %H:%M:%S %z',
-                '%Y-%m-%d %H:%M:%S',
-                '%Y/%m/%d %H:%M:%S',
-                '%Y-%m-%d',
-                '%Y/%m/%d'
-            ]
-            
-            for fmt in formats:
-                try:
-                    dt = datetime.strptime(date_str, fmt)
-                    if dt.tzinfo is None:
-                        dt = JST.localize(dt)
-                    return dt
-                except ValueError:
-                    continue
-                    
-        except Exception:
-            pass
-            
-        # 파싱에 실패한 경우 현재 시각 반환
-        return datetime.now(JST)
+        dt = extraction.parse_date(date_str)
+        if dt is None:
+            # 파싱에 실패한 경우 현재 시각 반환
+            return clock.now(JST)
+        return JST.localize(dt) if dt.tzinfo is None else dt
 
     def normalize_seminar(self, seminar_data: Dict) -> Dict:
         """세미나 데이터 정규화"""
         # 해시값 생성
-        hash_input = f"{seminar_data['title']}{seminar_data.get('event_date', '')}{seminar_data['status']}"
-        seminar_hash = hashlib.sha256(hash_input.encode('utf-8')).hexdigest()
+        seminar_hash = extraction.seminar_hash(seminar_data['title'], seminar_data.get('event_date', ''),
+                                               seminar_data['status'])
+
+        # 개최지 오프라인 지오코딩 (지명 사전에 없으면 좌표 없음)
+        place = self.config.gazetteer.lookup(seminar_data.get('location'))
         
         return {
             'region': seminar_data['region'],
+            'regions': seminar_data.get('regions') or [seminar_data['region']],
             'title': seminar_data['title'][:255],  # 길이 제한
             'event_date': seminar_data.get('event_date'),
             'location': seminar_data.get('location', '')[:255] if seminar_data.get('location') else None,
             'status': seminar_data['status'],
             'source_url': seminar_data['source_url'],
             'raw_text': seminar_data['raw_text'],
-            'hash': seminar_hash
+            'hash': seminar_hash,
+            'latitude': place.lat if place else None,
+            'longitude': place.lon if place else None,
+            'trace': seminar_data.get('trace')
         }
 
     def is_duplicated(self, seminar_hash: str) -> bool:
         """중복 확인 (과거 24시간 이내)"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
-        cutoff_time = datetime.now(JST) - timedelta(hours=24)
+        cutoff_time = clock.now(JST) - timedelta(hours=24)
         
         cursor.execute('''
             SELECT COUNT(*) FROM seminars 
@@ -621,26 +783,12 @@ class SeminarAutomationSystem:
         return count > 0
 
     def is_important(self, seminar: Dict) -> bool:
-        """중요 정보 판정"""
-        # 상태 기반 중요도 판정
-        important_statuses = ['모집 중', '모집 마감', '개최 예정']
-        
-        if seminar['status'] in important_statuses:
-            return True
-        
-        # 키워드 기반 중요도 판정
-        important_keywords = ['募集開始', '満員', '締切', '開催予定']
-        text_to_check = f"{seminar['title']} {seminar['raw_text']}".lower()
-        
-        for keyword in important_keywords:
-            if keyword.lower() in text_to_check:
-                return True
-                
-        return False
+        """중요 정보 판정 (상태 기반 → 키워드 기반)"""
+        return extraction.is_important(seminar['status'], seminar['title'], seminar['raw_text'])
 
     def save_seminar(self, seminar: Dict) -> int:
         """세미나 정보를 데이터베이스에 저장"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
         # 지역 ID 취득
@@ -663,6 +811,22 @@ class SeminarAutomationSystem:
                   seminar['raw_text'], seminar['hash']))
             
             seminar_id = cursor.lastrowid
+            regions = seminar.get('regions') or [seminar['region']]
+            cursor.execute(f'''
+                INSERT OR IGNORE INTO seminar_regions (seminar_id, region_id)
+                SELECT ?, region_id FROM regions WHERE name IN ({', '.join('?' * len(regions))})
+            ''', (seminar_id, *regions))
+            if seminar.get('latitude') is not None:
+                cursor.execute('''
+                    INSERT OR REPLACE INTO seminar_venues (seminar_id, place, latitude, longitude)
+                    VALUES (?, ?, ?, ?)
+                ''', (seminar_id, seminar['location'], seminar['latitude'], seminar['longitude']))
+            if seminar.get('event_date'):
+                fragment = render_vevent({**seminar, 'seminar_id': seminar_id})
+                cursor.execute('''
+                    INSERT OR REPLACE INTO seminar_vevents (seminar_id, fragment, fragment_hash)
+                    VALUES (?, ?, ?)
+                ''', (seminar_id, fragment, hashlib.sha1(fragment.encode('utf-8')).hexdigest()))
             conn.commit()
             conn.close()
             
@@ -689,7 +853,7 @@ class SeminarAutomationSystem:
                     event_date_str = f" [{seminar['event_date'].strftime('%Y-%m-%d')}]"
             
             location_str = f" @{seminar['location']}" if seminar.get('location') else ""
-            status_str = f" ({seminar['status']})" if seminar['status'] != '모집 중' else ""
+            status_str = f" ({seminar['status']})" if seminar['status'] != '募集中' else ""
             
             summary_parts.append(f"{i}. {seminar['title'][:80]}{event_date_str}{location_str}{status_str}")
         
@@ -702,7 +866,7 @@ class SeminarAutomationSystem:
 
     def get_subscribers_by_region(self, region: str) -> List[Dict]:
         """지역별 구독자 목록 취득"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
         cursor.execute('''
@@ -723,9 +887,81 @@ class SeminarAutomationSystem:
         conn.close()
         return subscribers
 
+    def get_proximity_subscriptions(self) -> List[Dict]:
+        """근접 구독 목록 취득 (기준 지명과 반경)"""
+        conn = self.runtime.connect(self.db_path)
+        cursor = conn.cursor()
+
+        cursor.execute('''
+            SELECT p.subscriber_id, s.name, p.place, p.radius_km
+            FROM subscriber_proximity p
+            JOIN subscribers s ON p.subscriber_id = s.subscriber_id
+        ''')
+
+        subscriptions = [
+            {'subscriber_id': row[0], 'name': row[1], 'place': row[2], 'radius_km': row[3]}
+            for row in cursor.fetchall()
+        ]
+
+        conn.close()
+        return subscriptions
+
+    def notify_nearby(self, seminars: List[Dict], traces_by_id: Dict, dry_run: bool) -> Tuple[int, int]:
+        """근접 구독자에게 반경 내 신착 세미나 발송 (격자 색인으로 검색)"""
+        subscriptions = self.get_proximity_subscriptions()
+        if not subscriptions:
+            return 0, 0
+
+        grid = GridIndex()
+        for index, seminar in enumerate(seminars):
+            if seminar.get('latitude') is not None:
+                grid.add(index, seminar['latitude'], seminar['longitude'])
+
+        sent = failed = 0
+        for subscription in subscriptions:
+            center = self.config.gazetteer.lookup(subscription['place'])
+            if center is None:
+                logger.warning(f"近接購読の基準地名が地名辞書にありません: {subscription['place']} ({subscription['name']})")
+                continue
+
+            route_started = time.time_ns()
+            nearby = [seminars[index] for index, _ in grid.within(center.lat, center.lon, subscription['radius_km'])]
+            if not nearby:
+                continue
+
+            logger.info(f"{subscription['place']}から{subscription['radius_km']:.0f}km以内: {len(nearby)}件 ({subscription['name']})")
+            summary = self.summarize_seminars(nearby)
+            routes = self.get_routing_info(subscription['subscriber_id'])
+            nearby_traces = [traces_by_id[seminar['seminar_id']] for seminar in nearby
+                             if seminar['seminar_id'] in traces_by_id]
+            for trace in nearby_traces:
+                trace.add_span('route', route_started, time.time_ns(),
+                               {'proximity': subscription['place'], 'radius_km': subscription['radius_km'], 'routes': len(routes)})
+
+            topic = f"{subscription['place']} {subscription['radius_km']:.0f}km以内"
+            for route in routes:
+                send_started = time.time_ns()
+                status, error = self.send_notification({**route, 'topic': topic}, summary, nearby, dry_run)
+                for trace in nearby_traces:
+                    trace.add_span('send', send_started, time.time_ns(),
+                                   {'channel': route['channel'], 'status': status, 'error': error or ''})
+                    if status == 'ok':
+                        trace.finish('delivered')
+
+                if status == 'queued':
+                    self.queued_deliveries.append((route, nearby_traces))
+                elif status == 'ok':
+                    sent += 1
+                else:
+                    failed += 1
+                    if error:
+                        logger.error(f"近接通知送信失敗: {error}")
+
+        return sent, failed
+
     def get_routing_info(self, subscriber_id: int) -> List[Dict]:
         """구독자의 라우팅 정보 취득"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
         cursor.execute('''
@@ -748,16 +984,22 @@ class SeminarAutomationSystem:
     def send_notification(self, route: Dict, summary: str, seminars: List[Dict], dry_run: bool = True) -> Tuple[str, str]:
         """통지 발송 (Dry-run 모드 지원)"""
         if route['channel'] == 'email':
-            return self.send_email_notification(route, summary, seminars, dry_run)
+            status, error = self.send_email_notification(route, summary, seminars, dry_run)
         elif route['channel'] == 'slack':
-            return self.send_slack_notification(route, summary, seminars, dry_run)
+            status, error = self.send_slack_notification(route, summary, seminars, dry_run)
+        elif route['channel'] == 'webhook':
+            status, error = self.send_webhook_notification(route, seminars, dry_run)
         else:
-            return 'fail', f"지원하지 않는 채널: {route['channel']}"
+            status, error = 'fail', f"지원하지 않는 채널: {route['channel']}"
+
+        if status != 'queued':
+            self.alerts.record('channel', route['channel'], status == 'ok')
+        return status, error
 
     def send_email_notification(self, route: Dict, summary: str, seminars: List[Dict], dry_run: bool = True) -> Tuple[str, str]:
         """이메일 통지 발송"""
         try:
-            subject = f"【海技士セミナー情報】{datetime.now(JST).strftime('%Y-%m-%d')} 重要情報 (新着 {len(seminars)}件)"
+            subject = f"【海技士セミナー情報】{clock.now(JST).strftime('%Y-%m-%d')} 重要情報 (新着 {len(seminars)}件)"
             
             body = f"""
 해기사 세미나 정보 자동화 시스템에서 알려드립니다.
@@ -779,7 +1021,7 @@ class SeminarAutomationSystem:
                 
                 body += f"\n・{seminar['title']}\n  상태: {seminar['status']}{event_date_str}{location_str}\n  URL: {seminar['source_url']}\n"
             
-            body += f"\n\n발송 시각: {datetime.now(JST).strftime('%Y-%m-%d %H:%M:%S')}"
+            body += f"\n\n발송 시각: {clock.now(JST).strftime('%Y-%m-%d %H:%M:%S')}"
             
             if dry_run:
                 logger.info(f"이메일 발송 (Dry-run): {route['address']} - {subject}")
@@ -817,23 +1059,72 @@ class SeminarAutomationSystem:
     def send_slack_notification(self, route: Dict, summary: str, seminars: List[Dict], dry_run: bool = True) -> Tuple[str, str]:
         """Slack 통지 발송"""
         try:
-            message = f"*해기사 세미나 정보 알림*\n\n{summary}\n\n발송 시각: {datetime.now(JST).strftime('%Y-%m-%d %H:%M:%S')}"
+            message = f"*해기사 세미나 정보 알림*\n\n{summary}\n\n발송 시각: {clock.now(JST).strftime('%Y-%m-%d %H:%M:%S')}"
             
             if dry_run:
                 logger.info(f"Slack 발송 (Dry-run): {route['address']} - 해기사 세미나 정보 {len(seminars)}건")
                 logger.debug(f"Slack 메시지 (Dry-run):\n{message}")
+            elif self.slack_threads and route.get('topic') and not route['address'].startswith('https://'):
+                # 부모 메시지에 스레드 답글 / 제자리 갱신 (창 안의 발송은 묶어서 처리)
+                logger.info(f"Slack 스레드 대기: {route['address']} [{route['topic']}] - 해기사 세미나 정보 {len(seminars)}건")
+                self.slack_threads.enqueue(route['address'], route['topic'], seminars)
+                return 'queued', None
             else:
-                # 실제 Slack API 호출 로직 (Webhook URL 또는 Bot Token 필요)
+                # Webhook URL 또는 Bot Token + 채널
                 logger.info(f"Slack 발송: {route['address']} - 해기사 세미나 정보 {len(seminars)}건")
+                ok, error = self.slack.send(route['address'], message)
+                if not ok:
+                    return 'fail', error
             
             return 'ok', None
             
         except Exception as e:
             return 'fail', str(e)
 
+    def send_webhook_notification(self, route: Dict, seminars: List[Dict], dry_run: bool = True) -> Tuple[str, str]:
+        """Webhook 통지 (엔드포인트별 대기열에 추가, 발송은 실행 끝의 일괄 POST)"""
+        if dry_run:
+            logger.info(f"Webhook 발송 (Dry-run): {route['address']} - 해기사 세미나 정보 {len(seminars)}건")
+        else:
+            logger.info(f"Webhook 대기: {route['address']} - 해기사 세미나 정보 {len(seminars)}건")
+            self.webhooks.add(route['address'], route.get('topic'), seminars)
+            return 'queued', None
+        return 'ok', None
+
+    def flush_queued_deliveries(self) -> Tuple[int, int]:
+        """대기 발송(Slack 스레드・갱신, Webhook)을 일괄 발송하고 경로별 최종 결과를 지표・알림・트레이스에 반영 → (성공, 실패)"""
+        started = time.time_ns()
+        outcomes = {}
+        if self.slack_threads:
+            self.slack_threads.flush()
+            outcomes['slack'] = self.slack_threads.take_outcomes()
+        # 엔드포인트별 Webhook 일괄 발송 (엔드포인트의 배치가 하나라도 실패하면 그 경로는 실패)
+        self.webhooks.flush()
+        outcomes['webhook'] = self.webhooks.take_outcomes()
+        ended = time.time_ns()
+
+        sent = failed = 0
+        queued, self.queued_deliveries = self.queued_deliveries, []
+        for route, traces in queued:
+            key = route['address'] if route['channel'] == 'webhook' else (route['address'], route.get('topic'))
+            error = outcomes.get(route['channel'], {}).get(key, '送信結果なし')
+            status = 'fail' if error else 'ok'
+            self.alerts.record('channel', route['channel'], status == 'ok')
+            for trace in traces:
+                trace.add_span('flush', started, ended, {'channel': route['channel'], 'status': status, 'error': error or ''})
+                if status == 'ok':
+                    trace.finish('delivered')
+
+            if status == 'ok':
+                sent += 1
+            else:
+                failed += 1
+                logger.error(f"通知送信失敗: {route['address']} - {error}")
+        return sent, failed
+
     def log_notification(self, seminar_id: int, channel: str, address: str, status: str, error: str = None):
         """통지 로그 기록"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
         cursor.execute('''
@@ -846,15 +1137,16 @@ class SeminarAutomationSystem:
 
     def get_new_important_seminars_by_region(self, region: str) -> List[Dict]:
         """지역별 신착 중요 세미나 취득"""
-        conn = sqlite3.connect(self.db_path)
+        conn = self.runtime.connect(self.db_path)
         cursor = conn.cursor()
         
-        cutoff_time = datetime.now(JST) - timedelta(hours=24)
+        cutoff_time = clock.now(JST) - timedelta(hours=24)
         
         cursor.execute('''
             SELECT s.seminar_id, s.title, s.event_date, s.location, s.status, s.source_url, s.raw_text
             FROM seminars s
-            JOIN regions r ON s.region_id = r.region_id
+            JOIN seminar_regions sr ON sr.seminar_id = s.seminar_id
+            JOIN regions r ON sr.region_id = r.region_id
             WHERE r.name = ? AND s.created_at > ?
             ORDER BY s.created_at DESC
         ''', (region, cutoff_time))
@@ -878,134 +1170,191 @@ class SeminarAutomationSystem:
         conn.close()
         return seminars
 
-    def check_failures_and_notify_ops(self):
-        """발송 실패 확인 및 운영 담당자 통지"""
-        conn = sqlite3.connect(self.db_path)
-        cursor = conn.cursor()
-        
-        # 과거 1시간의 발송 실패 확인
-        cutoff_time = datetime.now(JST) - timedelta(hours=1)
-        
-        cursor.execute('''
-            SELECT COUNT(*) FROM seminar_notifications 
-            WHERE status = 'fail' AND sent_at > ?
-        ''', (cutoff_time,))
-        
-        failure_count = cursor.fetchone()[0]
-        
-        if failure_count > 0:
-            logger.warning(f"세미나 정보 발송 실패가 {failure_count}건 발생했습니다")
-            # 실제 구현에서는 운영 담당자에게 통지 발송
-        
-        conn.close()
+    def check_failures_and_notify_ops(self, dry_run: bool = True):
+        """발송 실패 알림을 운영 담당자에게 통지 (판정은 기록 시점에 완료, DB 조회 없음)"""
+        sent = self.alerts.flush(dry_run)
+        if sent:
+            logger.warning(f"運用アラート: {sent}件")
 
     def main_process(self, dry_run: bool = True):
         """메인 처리"""
         logger.info("海技士セミナー情報自動化システム開始")
-        
+
+        self.memory.start()
+        try:
+            self._run_pipeline(dry_run)
+        except Exception:
+            self.snapshots.discard()
+            raise
+        finally:
+            self.memory.report()
+            self.memory.stop()
+            self.tracer.flush()
+
+    def _run_pipeline(self, dry_run: bool):
+        """수집부터 발송까지의 파이프라인"""
         # 통계 변수
         total_collected = 0
         total_new_important = 0
         total_notifications_sent = 0
         total_notifications_failed = 0
+        self.queued_deliveries = []
         
         # 1. 수집
-        raw_seminars = self.collect_seminars_from_all_sources()
+        with self.memory.stage('collect'):
+            raw_seminars = self.collect_seminars_from_all_sources()
         total_collected = len(raw_seminars)
         logger.info(f"総収集件数: {total_collected}")
         
         processed_seminars = []
-        
-        for seminar_data in raw_seminars:
-            # 2. 정규화
-            normalized_seminar = self.normalize_seminar(seminar_data)
-            
-            # 3. 중복 제거
-            if self.is_duplicated(normalized_seminar['hash']):
-                continue
-            
-            # 4. 중요 정보 추출
-            if not self.is_important(normalized_seminar):
-                continue
-            
-            # 데이터베이스에 저장
-            seminar_id = self.save_seminar(normalized_seminar)
-            if seminar_id:
-                normalized_seminar['seminar_id'] = seminar_id
-                processed_seminars.append(normalized_seminar)
-        
-        total_new_important = len(processed_seminars)
-        logger.info(f"新着重要セミナー: {total_new_important}")
-        
-        # 5. 지역별 요약 및 발송 (정보가 없어도 발송)
-        all_subscribers = self.get_all_subscribers()
-
-        if all_subscribers:  # 구독자가 있으면 반드시 메일 발송
-            # 신착 정보가 있는지 확인
-            if total_new_important > 0:
-                # 신착 정보가 있는 경우
-                for region in self.transport_bureaus.keys():
-                    important_seminars = self.get_new_important_seminars_by_region(region)
+        traces_by_id = {}
+
+        with self.memory.stage('process'):
+            # 메모리 압박 시 배치 크기를 줄여 처리
+            index = 0
+            while index < len(raw_seminars):
+                batch = raw_seminars[index:index + self.memory.scale(self.process_batch_size)]
+                index += len(batch)
+
+                for seminar_data in batch:
+                    trace = seminar_data.get('trace') or self.tracer.start_trace(seminar_data['source_url'])
+
+                    # 2. 정규화
+                    normalized_seminar = self.normalize_seminar(seminar_data)
+
+                    # 3. 중복 제거
+                    with trace.span('dedup') as span:
+                        duplicated = self.is_duplicated(normalized_seminar['hash'])
+                        span.set('duplicate', duplicated)
+                    if duplicated:
+                        trace.finish('dropped:duplicate')
+                        continue
 
-                    if not important_seminars:
+                    # 4. 중요 정보 추출
+                    with trace.span('importance') as span:
+                        important = self.is_important(normalized_seminar)
+                        span.set('important', important)
+                    if not important:
+                        trace.finish('dropped:not_important')
                         continue
 
-                    logger.info(f"{region}地域: {len(important_seminars)}件の重要セミナー")
-                    summary = self.summarize_seminars(important_seminars)
+                    # 데이터베이스에 저장
+                    with trace.span('persist') as span:
+                        seminar_id = self.save_seminar(normalized_seminar)
+                        span.set('seminar_id', seminar_id)
+                    if seminar_id:
+                        normalized_seminar['seminar_id'] = seminar_id
+                        processed_seminars.append(normalized_seminar)
+                        traces_by_id[seminar_id] = trace
+                        trace.outcome = 'stored'
+                    else:
+                        trace.finish('dropped:persist_conflict')
 
-                    subscribers_in_region = self.get_subscribers_by_region(region)
+                if self.memory.under_pressure():
+                    self.memory.relieve()
 
-                    for subscriber in subscribers_in_region:
-                        routes = self.get_routing_info(subscriber['subscriber_id'])
+        # 처리 완료 후 스냅샷 확정 (도중 실패 시 다음 실행에서 변경분을 다시 처리)
+        self.snapshots.commit()
 
-                        for route in routes:
+        # 저장 시 조각을 만들지 못한 세미나 보완 (피드 요청 시에는 저장된 조각만 연결)
+        self.calendar.refresh_fragments()
+        
+        total_new_important = len(processed_seminars)
+        logger.info(f"新着重要セミナー: {total_new_important}")
+        
+        with self.memory.stage('notify'):
+            # 5. 지역별 요약 및 발송 (정보가 없어도 발송)
+            all_subscribers = self.get_all_subscribers()
+
+            if all_subscribers:  # 구독자가 있으면 반드시 메일 발송
+                # 신착 정보가 있는지 확인
+                if total_new_important > 0:
+                    # 신착 정보가 있는 경우
+                    for region in self.transport_bureaus.keys():
+                        important_seminars = self.get_new_important_seminars_by_region(region)
+
+                        if not important_seminars:
+                            continue
+
+                        logger.info(f"{region}地域: {len(important_seminars)}件の重要セミナー")
+                        summary = self.summarize_seminars(important_seminars)
+
+                        route_started = time.time_ns()
+                        subscribers_in_region = self.get_subscribers_by_region(region)
+                        region_routes = [{**route, 'topic': region} for subscriber in subscribers_in_region
+                                         for route in self.get_routing_info(subscriber['subscriber_id'])]
+                        region_traces = [traces_by_id[seminar['seminar_id']] for seminar in important_seminars
+                                         if seminar['seminar_id'] in traces_by_id]
+                        for trace in region_traces:
+                            trace.add_span('route', route_started, time.time_ns(),
+                                           {'region': region, 'subscribers': len(subscribers_in_region), 'routes': len(region_routes)})
+
+                        for route in region_routes:
+                            send_started = time.time_ns()
                             status, error = self.send_notification(route, summary, important_seminars, dry_run)
-
-                            if status == 'ok':
+                            for trace in region_traces:
+                                trace.add_span('send', send_started, time.time_ns(),
+                                               {'channel': route['channel'], 'status': status, 'error': error or ''})
+                                if status == 'ok':
+                                    trace.finish('delivered')
+
+                            if status == 'queued':
+                                self.queued_deliveries.append((route, region_traces))
+                            elif status == 'ok':
                                 total_notifications_sent += 1
                             else:
                                 total_notifications_failed += 1
                                 if error:
                                     logger.error(f"通知送信失敗: {error}")
-            else:
-                # 신착 정보가 없는 경우 - 상태 보고 메일 발송
-                logger.info("新着セミナー情報なし - ステータスレポート送信")
-                recent_seminars = self.get_recent_seminars(1)  # 최근 1건 가져오기
-                summary = self.create_no_new_info_summary(recent_seminars)
-
-                # 모든 구독자에게 상태 보고 메일 발송
-                for subscriber_email in all_subscribers:
-                    route = {'channel': 'email', 'address': subscriber_email}
-                    status, error = self.send_notification(route, summary, recent_seminars, dry_run)
-
-                    if status == 'ok':
-                        total_notifications_sent += 1
-                    else:
-                        total_notifications_failed += 1
-                        if error:
-                            logger.error(f"ステータスレポート送信失敗: {error}")
 
-        # 기존 코드 계속 (더미 처리)
-        if False:  # 위에서 처리했으므로 실행되지 않음
-            subscribers_in_region = []
+                    # 근접 구독 (예: 広島から100km以内)
+                    sent, failed = self.notify_nearby(processed_seminars, traces_by_id, dry_run)
+                    total_notifications_sent += sent
+                    total_notifications_failed += failed
+                else:
+                    # 신착 정보가 없는 경우 - 상태 보고 메일 발송
+                    logger.info("新着セミナー情報なし - ステータスレポート送信")
+                    recent_seminars = self.get_recent_seminars(1)  # 최근 1건 가져오기
+                    summary = self.create_no_new_info_summary(recent_seminars)
+
+                    # 모든 구독자에게 상태 보고 메일 발송
+                    for subscriber_email in all_subscribers:
+                        route = {'channel': 'email', 'address': subscriber_email}
+                        status, error = self.send_notification(route, summary, recent_seminars, dry_run)
+
+                        if status == 'ok':
+                            total_notifications_sent += 1
+                        else:
+                            total_notifications_failed += 1
+                            if error:
+                                logger.error(f"ステータスレポート送信失敗: {error}")
+
+            # 창 안에 남은 Slack 스레드 대기분・Webhook 일괄 발송 후 경로별 결과 반영
+            sent, failed = self.flush_queued_deliveries()
+            total_notifications_sent += sent
+            total_notifications_failed += failed
+
+            # 기존 코드 계속 (더미 처리)
+            if False:  # 위에서 처리했으므로 실행되지 않음
+                subscribers_in_region = []
             
-            for subscriber in subscribers_in_region:
-                routes = self.get_routing_info(subscriber['subscriber_id'])
+                for subscriber in subscribers_in_region:
+                    routes = self.get_routing_info(subscriber['subscriber_id'])
                 
-                for route in routes:
-                    status, error = self.send_notification(route, summary, important_seminars, dry_run)
+                    for route in routes:
+                        status, error = self.send_notification(route, summary, important_seminars, dry_run)
                     
-                    if status == 'ok':
-                        total_notifications_sent += 1
-                    else:
-                        total_notifications_failed += 1
+                        if status == 'ok':
+                            total_notifications_sent += 1
+                        else:
+                            total_notifications_failed += 1
                     
-                    # 8. 로그 기록
-                    for seminar in important_seminars:
-                        self.log_notification(seminar['seminar_id'], route['channel'], route['address'], status, error)
+                        # 8. 로그 기록
+                        for seminar in important_seminars:
+                            self.log_notification(seminar['seminar_id'], route['channel'], route['address'], status, error)
         
         # 9. 모니터링 및 알림
-        self.check_failures_and_notify_ops()
+        self.check_failures_and_notify_ops(dry_run)
         
         # 최종 통계 로그
         logger.info(f"해기사 세미나 정보 자동화 시스템 완료 - 순회: {total_collected}, 신착: {total_new_important}, 통지 성공: {total_notifications_sent}, 통지 실패: {total_notifications_failed}")
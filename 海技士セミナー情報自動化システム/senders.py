@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 메일・Slack 발송 계층
+Author: Manus AI
+Date: 2025-09-26
+"""
+
+import os
+import time
+import logging
+import smtplib
+import threading
+from email.mime.text import MIMEText
+from email.mime.multipart import MIMEMultipart
+from typing import Dict, List, Optional, Tuple
+
+import requests
+
+import clock
+
+logger = logging.getLogger(__name__)
+
+
+class SmtpPool:
+    """SMTP 연결 풀 (로그인한 연결을 재사용, 유휴 시간 초과・끊긴 연결은 폐기 후 재접속)"""
+
+    def __init__(self):
+        self.server = os.getenv('SMTP_SERVER', 'smtp.gmail.com')
+        self.port = int(os.getenv('SMTP_PORT', '587'))
+        self.username = os.getenv('SMTP_USERNAME')
+        self.password = os.getenv('SMTP_PASSWORD')
+        self.from_email = os.getenv('FROM_EMAIL', self.username)
+        self.max_size = int(os.getenv('SMTP_POOL_SIZE', '2'))
+        self.idle_seconds = float(os.getenv('SMTP_IDLE_SECONDS', '60'))
+        self._idle: List[Tuple[smtplib.SMTP, float]] = []  # (연결, 반환 시각), 마지막에 반환된 것부터 사용
+        self._created = 0
+        self._available = threading.Condition()  # 반환・폐기 시 대기 중인 발송에 통지
+
+    @property
+    def configured(self) -> bool:
+        return bool(self.username and self.password)
+
+    def _connect(self) -> smtplib.SMTP:
+        logger.info(f"SMTP 설정: {self.server}:{self.port}")
+        server = smtplib.SMTP(self.server, self.port, timeout=30)
+        server.starttls()
+        server.login(self.username, self.password)
+        return server
+
+    def _acquire(self) -> smtplib.SMTP:
+        stale = []
+        try:
+            with self._available:
+                while True:
+                    while self._idle:
+                        server, returned_at = self._idle.pop()
+                        if time.monotonic() - returned_at < self.idle_seconds:
+                            return server
+                        self._created -= 1
+                        stale.append(server)
+                    if self._created < self.max_size:
+                        self._created += 1
+                        break
+                    self._available.wait()  # 상한 도달 시 반환・폐기 대기
+        finally:
+            for server in stale:
+                self._quit(server)
+
+        try:
+            return self._connect()
+        except Exception:
+            with self._available:
+                self._created -= 1
+                self._available.notify()
+            raise
+
+    def _release(self, server: smtplib.SMTP):
+        with self._available:
+            self._idle.append((server, time.monotonic()))
+            self._available.notify()
+
+    def _discard(self, server: smtplib.SMTP):
+        with self._available:
+            self._created -= 1
+            self._available.notify()
+        self._quit(server)
+
+    @staticmethod
+    def _quit(server: smtplib.SMTP):
+        try:
+            server.quit()
+        except Exception:
+            pass
+
+    def send(self, to_email: str, subject: str, html_content: str, text_content: str = None) -> bool:
+        """HTML 메일 발송 (재사용한 연결이 끊겨 있으면 새 연결로 1회 재시도)"""
+        if not self.configured:
+            logger.error("SMTP 인증 정보가 설정되지 않았습니다")
+            return False
+
+        msg = MIMEMultipart('alternative')
+        msg['Subject'] = subject
+        msg['From'] = self.from_email
+        msg['To'] = to_email
+        if text_content:
+            msg.attach(MIMEText(text_content, 'plain', 'utf-8'))
+        msg.attach(MIMEText(html_content, 'html', 'utf-8'))
+
+        for attempt in range(2):
+            try:
+                server = self._acquire()
+            except Exception as e:
+                logger.error(f"메일 발송 실패: {str(e)}")
+                return False
+            try:
+                server.send_message(msg)
+            except smtplib.SMTPServerDisconnected as e:
+                self._discard(server)
+                if attempt == 0:
+                    continue
+                logger.error(f"메일 발송 실패: {str(e)}")
+                return False
+            except Exception as e:
+                self._discard(server)
+                logger.error(f"메일 발송 실패: {str(e)}")
+                return False
+            self._release(server)
+            logger.info(f"✅ 메일 발송 성공: {subject}")
+            return True
+        return False
+
+    def close(self):
+        with self._available:
+            idle, self._idle = self._idle, []
+        for server, _ in idle:
+            self._discard(server)
+
+
+class SlackSender:
+    """Slack 발송 (Incoming Webhook URL 또는 Bot Token + 채널), HTTP 세션 재사용"""
+
+    def __init__(self):
+        self.bot_token = os.getenv('SLACK_BOT_TOKEN')
+        self.api_url = os.getenv('SLACK_API_URL', 'https://slack.com/api').rstrip('/')  # 로컬 스텁으로 교체 가능
+        self.timeout = float(os.getenv('REQUEST_TIMEOUT', '30'))
+        self.max_retry_after = float(os.getenv('SLACK_MAX_RETRY_AFTER', '30'))
+        self.session = requests.Session()
+        self.api_calls = 0
+        self._lock = threading.Lock()
+
+    def send(self, address: str, text: str) -> Tuple[bool, Optional[str]]:
+        """address: Webhook URL 또는 채널명(#ops 등)"""
+        if address.startswith('https://'):
+            try:
+                with self._lock:
+                    self.api_calls += 1
+                response = self.session.post(address, json={'text': text}, timeout=self.timeout)
+                if response.status_code != 200:
+                    return False, f"Slack Webhook 응답 {response.status_code}"
+                return True, None
+            except requests.RequestException as e:
+                return False, str(e)
+
+        ts, _, error = self.post(address, text)
+        return ts is not None, error
+
+    def post(self, channel: str, text: str, thread_ts: str = None) -> Tuple[Optional[str], Optional[str], Optional[str]]:
+        """chat.postMessage → (ts, 채널 ID, 오류), thread_ts 지정 시 스레드 답글"""
+        payload = {'channel': channel, 'text': text}
+        if thread_ts:
+            payload['thread_ts'] = thread_ts
+        result, error = self.call('chat.postMessage', payload)
+        if error:
+            return None, None, error
+        return result.get('ts'), result.get('channel'), None
+
+    def update(self, channel_id: str, ts: str, text: str) -> Tuple[bool, Optional[str]]:
+        """chat.update (채널명이 아닌 채널 ID 필요)"""
+        _, error = self.call('chat.update', {'channel': channel_id, 'ts': ts, 'text': text})
+        return error is None, error
+
+    def call(self, method: str, payload: Dict) -> Tuple[Dict, Optional[str]]:
+        """Web API 호출 (Bot Token), 속도 제한(429)은 Retry-After 만큼 대기 후 1회 재시도"""
+        if not self.bot_token:
+            return {}, "SLACK_BOT_TOKEN이 설정되지 않았습니다"
+
+        for attempt in range(2):
+            try:
+                with self._lock:
+                    self.api_calls += 1
+                response = self.session.post(f"{self.api_url}/{method}",
+                                             headers={'Authorization': f"Bearer {self.bot_token}"},
+                                             json=payload, timeout=self.timeout)
+                if response.status_code == 429 and attempt == 0:
+                    retry_after = float(response.headers.get('Retry-After', '1'))
+                    if retry_after <= self.max_retry_after:
+                        logger.warning(f"Slack API 속도 제한: {method} ({retry_after:.0f}초 후 재시도)")
+                        clock.sleep(retry_after)
+                        continue
+                result = response.json()
+            except (requests.RequestException, ValueError) as e:
+                return {}, str(e)
+            if not result.get('ok'):
+                return result, f"Slack API 오류: {result.get('error')}"
+            return result, None
+        return {}, "Slack API 오류: rate_limited"
@@ -0,0 +1,450 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 가상 시계 스케줄 시뮬레이션
+Author: Manus AI
+Date: 2025-09-26
+
+SeminarScheduler 의 스케줄(매일 메인 프로세스・재시도・상태 확인)을 가상 시계로 빨리 감아
+재시도・정지 후 따라잡기 실행을 실시간을 기다리지 않고 확인한다.
+- HTTP 는 픽스처 디렉터리에서 재생 (index.json: URL → 응답 파일, 날짜별 교체 가능)
+- 메일・Slack 은 로컬 싱크로 보냄 (mail.mbox, slack.jsonl - Slack 은 스레드・갱신 API 스텁 포함) - 실제 발송 없음
+- Webhook 은 로컬 스텁 수신 서버(127.0.0.1)로 실제 HTTP POST (서명 검증, webhook.jsonl 에 기록,
+  --webhook-fail-rate 로 503 을 섞어 재시도 경로 확인). subscribers.json 의 주소 '{webhook}' 이 서버 URL 로 치환됨
+- DB 는 출력 디렉터리 아래를 사용하고, 1회당 CPU 시간을 집계
+
+픽스처 index.json 예:
+    {"https://example.jp/seminar.html": [
+        {"file": "seminar_v1.html"},
+        {"from": "2025-10-15", "file": "seminar_v2.html", "etag": "\"v2\""}]}
+
+사용 예:
+    python simulation.py --days 90 --fixtures ./fixtures --output ./sim
+    python simulation.py --days 30 --fail-rate 0.2 --outage 2025-10-03T05:00+8
+    python simulation.py --days 14 --fixtures ./fixtures --webhook-fail-rate 0.3
+"""
+
+import os
+import json
+import time
+import random
+import logging
+import mailbox
+import argparse
+import sqlite3
+import threading
+from datetime import date, datetime, timedelta
+from email.mime.multipart import MIMEMultipart
+from email.mime.text import MIMEText
+from email.utils import format_datetime
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+import pytz
+import requests
+import schedule
+from requests.adapters import BaseAdapter
+from requests.structures import CaseInsensitiveDict
+
+import clock
+from clock import VirtualClock
+from job_executor import JobExecutor
+from webhooks import SIGNATURE_HEADER, TIMESTAMP_HEADER, DELIVERY_HEADER, sign
+
+JST = pytz.timezone('Asia/Tokyo')
+
+logger = logging.getLogger(__name__)
+
+TICK_SECONDS = 0.001
+
+
+def parse_outage(text: str) -> Tuple[float, float]:
+    """'2025-10-03T05:00+8' → (시작, 종료) 스케줄러 정지 구간 (시간 단위)"""
+    start, hours = text.rsplit('+', 1)
+    begin = JST.localize(datetime.fromisoformat(start))
+    return begin.timestamp(), (begin + timedelta(hours=float(hours))).timestamp()
+
+
+class ReplayAdapter(BaseAdapter):
+    """픽스처 재생용 requests 어댑터 (가상 날짜 기준으로 응답 선택, ETag 일치 시 304)"""
+
+    def __init__(self, fixtures_dir: Optional[str]):
+        super().__init__()
+        self.fixtures_dir = Path(fixtures_dir) if fixtures_dir else None
+        self.index: Dict[str, List[Dict]] = {}
+        if self.fixtures_dir and (self.fixtures_dir / 'index.json').exists():
+            with open(self.fixtures_dir / 'index.json', 'r', encoding='utf-8') as f:
+                for url, entries in json.load(f).items():
+                    entries = entries if isinstance(entries, list) else [entries]
+                    self.index[url] = sorted(entries, key=lambda entry: entry.get('from', ''))
+        self.hits = 0
+        self.misses = 0
+        self._lock = threading.Lock()
+
+    def _entry(self, url: str) -> Optional[Dict]:
+        today = clock.now(JST).date().isoformat()
+        current = None
+        for entry in self.index.get(url, []):
+            if entry.get('from', '') <= today:
+                current = entry
+        return current
+
+    def send(self, request, **kwargs) -> requests.Response:
+        entry = self._entry(request.url)
+        with self._lock:
+            if entry is None:
+                self.misses += 1
+            else:
+                self.hits += 1
+
+        response = requests.Response()
+        response.url = request.url
+        response.request = request
+        response.encoding = 'utf-8'
+        response.headers = CaseInsensitiveDict(entry.get('headers', {}) if entry else {})
+        if entry is None:
+            response.status_code, response._content = 404, b''
+        elif entry.get('etag') and request.headers.get('If-None-Match') == entry['etag']:
+            response.headers['ETag'] = entry['etag']
+            response.status_code, response._content = 304, b''
+        else:
+            if entry.get('etag'):
+                response.headers['ETag'] = entry['etag']
+            response.status_code = entry.get('status', 200)
+            response._content = (self.fixtures_dir / entry['file']).read_bytes() if entry.get('file') else b''
+        return response
+
+    def close(self):
+        pass
+
+
+class SmtpSink:
+    """SmtpPool 대체: 메일을 mbox 에 기록"""
+
+    configured = True
+
+    def __init__(self, path: Path):
+        self.mbox = mailbox.mbox(str(path))
+        self.sent = 0
+        self._lock = threading.Lock()
+
+    def send(self, to_email: str, subject: str, html_content: str, text_content: str = None) -> bool:
+        msg = MIMEMultipart('alternative')
+        msg['Subject'] = subject
+        msg['From'] = 'simulation@localhost'
+        msg['To'] = to_email
+        msg['Date'] = format_datetime(clock.now(JST))
+        if text_content:
+            msg.attach(MIMEText(text_content, 'plain', 'utf-8'))
+        msg.attach(MIMEText(html_content, 'html', 'utf-8'))
+        with self._lock:
+            self.mbox.add(msg)
+            self.mbox.flush()
+            self.sent += 1
+        return True
+
+    def close(self):
+        self.mbox.close()
+
+
+class SlackSink:
+    """SlackSender 대체 (Web API 스텁): 메시지・스레드 답글・갱신을 JSON Lines 로 기록"""
+
+    def __init__(self, path: Path):
+        self.path = path
+        self.sent = 0
+        self.api_calls = 0
+        self._ts = 0
+        self._lock = threading.Lock()
+
+    def _record(self, entry: Dict):
+        with self._lock:
+            with open(self.path, 'a', encoding='utf-8') as f:
+                f.write(json.dumps({'at': clock.now(JST).isoformat(), **entry}, ensure_ascii=False) + '\n')
+            self.sent += 1
+            self.api_calls += 1
+
+    def send(self, address: str, text: str) -> Tuple[bool, Optional[str]]:
+        self._record({'address': address, 'text': text})
+        return True, None
+
+    def post(self, channel: str, text: str, thread_ts: str = None) -> Tuple[Optional[str], Optional[str], Optional[str]]:
+        with self._lock:
+            self._ts += 1
+            ts = f"{clock.time():.0f}.{self._ts:06d}"
+        self._record({'method': 'chat.postMessage', 'address': channel, 'ts': ts, 'thread_ts': thread_ts, 'text': text})
+        return ts, f"C{abs(hash(channel)) % 10 ** 8:08d}", None
+
+    def update(self, channel_id: str, ts: str, text: str) -> Tuple[bool, Optional[str]]:
+        self._record({'method': 'chat.update', 'address': channel_id, 'ts': ts, 'text': text})
+        return True, None
+
+
+class WebhookReceiver:
+    """로컬 스텁 수신 서버: 서명 검증 후 배치를 JSON Lines 로 기록 (fail_rate 비율로 503 응답)"""
+
+    def __init__(self, path: Path, secret: str, fail_rate: float = 0.0, seed: int = 0):
+        self.path = path
+        self.secret = secret
+        self.fail_rate = fail_rate
+        self.rng = random.Random(seed)
+        self.stats = {'requests': 0, 'accepted': 0, 'rejected': 0, 'bad_signature': 0,
+                      'duplicate': 0, 'items': 0, 'max_concurrent': 0}
+        self._deliveries = set()
+        self._active = 0
+        self._lock = threading.Lock()
+        receiver = self
+
+        class Handler(BaseHTTPRequestHandler):
+            protocol_version = 'HTTP/1.1'  # keep-alive (송신 측 연결 재사용 확인)
+
+            def do_POST(self):
+                body = self.rfile.read(int(self.headers.get('Content-Length', 0)))
+                status = receiver.receive(self.path, self.headers, body)
+                self.send_response(status)
+                self.send_header('Content-Length', '0')
+                self.end_headers()
+
+            def log_message(self, *args):
+                pass
+
+        self.server = ThreadingHTTPServer(('127.0.0.1', 0), Handler)
+        self.server.daemon_threads = True
+        self.url = f"http://127.0.0.1:{self.server.server_address[1]}"
+        threading.Thread(target=self.server.serve_forever, daemon=True).start()
+
+    def receive(self, endpoint: str, headers, body: bytes) -> int:
+        with self._lock:
+            self.stats['requests'] += 1
+            self._active += 1
+            self.stats['max_concurrent'] = max(self.stats['max_concurrent'], self._active)
+            fail = self.rng.random() < self.fail_rate
+        try:
+            expected = sign(self.secret, headers.get(TIMESTAMP_HEADER, ''), body)
+            if headers.get(SIGNATURE_HEADER) != expected:
+                with self._lock:
+                    self.stats['bad_signature'] += 1
+                return 401
+            if fail:
+                with self._lock:
+                    self.stats['rejected'] += 1
+                return 503
+            payload = json.loads(body)
+            with self._lock:
+                delivery = headers.get(DELIVERY_HEADER)
+                if delivery in self._deliveries:
+                    self.stats['duplicate'] += 1
+                    return 200
+                self._deliveries.add(delivery)
+                self.stats['accepted'] += 1
+                self.stats['items'] += len(payload['items'])
+                with open(self.path, 'a', encoding='utf-8') as f:
+                    f.write(json.dumps({'at': clock.now(JST).isoformat(), 'endpoint': endpoint, **payload},
+                                       ensure_ascii=False) + '\n')
+            return 200
+        finally:
+            with self._lock:
+                self._active -= 1
+
+    def close(self):
+        self.server.shutdown()
+        self.server.server_close()
+
+
+class JobCosts:
+    """작업별 실행 횟수・CPU 시간・가상 소요 시간"""
+
+    def __init__(self, sim_clock: VirtualClock):
+        self.clock = sim_clock
+        self.runs: Dict[str, List[Tuple[float, float, float]]] = {}  # (시작 가상 시각, CPU 초, 가상 초)
+        self._lock = threading.Lock()
+
+    def wrap(self, executor: JobExecutor):
+        for spec in executor.specs.values():
+            spec.fn = self._measured(spec.name, spec.fn)
+
+    def _measured(self, name: str, fn):
+        def run(*args):
+            started, cpu = self.clock.time(), time.thread_time()
+            try:
+                return fn(*args)
+            finally:
+                with self._lock:
+                    self.runs.setdefault(name, []).append(
+                        (started, time.thread_time() - cpu, self.clock.time() - started))
+        return run
+
+    def summary(self) -> Dict[str, Dict]:
+        result = {}
+        for name, runs in sorted(self.runs.items()):
+            cpu_ms = sorted(run[1] * 1000 for run in runs)
+            result[name] = {
+                'runs': len(runs),
+                'cpu_ms_mean': round(sum(cpu_ms) / len(cpu_ms), 2),
+                'cpu_ms_p95': round(cpu_ms[min(len(cpu_ms) - 1, int(len(cpu_ms) * 0.95))], 2),
+                'cpu_ms_max': round(cpu_ms[-1], 2),
+                'virtual_minutes_mean': round(sum(run[2] for run in runs) / len(runs) / 60, 1),
+                'first_runs': [datetime.fromtimestamp(run[0], JST).strftime('%Y-%m-%d %a %H:%M')
+                               for run in runs[:3]],
+            }
+        return result
+
+
+def drive(sim_clock: VirtualClock, executor: JobExecutor, until: float,
+          outages: List[Tuple[float, float]]) -> int:
+    """다음 이벤트 시각으로 차례로 시계를 진행하며 run_pending() → 처리한 이벤트 수"""
+    events = 0
+    while True:
+        # 실행 중인 작업이 모두 가상 sleep 중(또는 종료)이 된 뒤에 진행
+        if not sim_clock.wait_quiescent(executor.busy):
+            logger.error("シミュレーション停止: ジョブが仮想時計外で待機しています")
+            break
+        next_run = schedule.next_run()
+        # 실제 운용처럼 예정 시각 직후에 run_pending() 호출
+        # (정확히 예정 시각이면 schedule 이 다음 실행을 같은 시각으로 재계산하는 경우가 있음)
+        scheduled = next_run.timestamp() + TICK_SECONDS if next_run else None
+        for begin, end in outages:
+            if scheduled is not None and begin <= scheduled < end:
+                scheduled = end  # 정지 중에는 run_pending() 하지 않음 (재개 시 따라잡기 실행)
+        candidates = [t for t in (scheduled, sim_clock.next_wake()) if t is not None]
+        if not candidates or min(candidates) > until:
+            break
+        target = min(candidates)
+        sim_clock.advance_to(target)
+        if not any(begin <= target < end for begin, end in outages):
+            schedule.run_pending()
+        events += 1
+
+    # 새 투입을 멈추고 실행 중인 작업을 끝까지 진행
+    schedule.clear()
+    while executor.busy():
+        sim_clock.wait_quiescent(executor.busy)
+        wake = sim_clock.next_wake()
+        if wake is None:
+            break
+        sim_clock.advance_to(wake)
+    return events
+
+
+def seed_subscribers(db_path: str, path: Path, webhook_url: str):
+    """subscribers.json ([{name, region, routes: [{channel, address}]}]) 로 구독자 등록 (주소의 '{webhook}' 은 스텁 수신 서버)"""
+    with open(path, 'r', encoding='utf-8') as f:
+        subscribers = json.load(f)
+    conn = sqlite3.connect(db_path)
+    with conn:
+        for subscriber in subscribers:
+            region = conn.execute('SELECT region_id FROM regions WHERE name = ?',
+                                  (subscriber.get('region'),)).fetchone()
+            cursor = conn.execute('INSERT INTO subscribers (name, region_id) VALUES (?, ?)',
+                                  (subscriber['name'], region[0] if region else None))
+            for route in subscriber.get('routes', []):
+                conn.execute('INSERT INTO subscriber_routing (subscriber_id, channel, address) VALUES (?, ?, ?)',
+                             (cursor.lastrowid, route['channel'], route['address'].replace('{webhook}', webhook_url)))
+    conn.close()
+
+
+def run_simulation(days: float, start: Optional[datetime] = None, fixtures_dir: Optional[str] = None,
+                   output_dir: str = './sim', dry_run: bool = False, fail_rate: float = 0.0, seed: int = 0,
+                   outages: Optional[List[Tuple[float, float]]] = None,
+                   noop_jobs: Optional[List[str]] = None, webhook_fail_rate: float = 0.0) -> Dict:
+    output = Path(output_dir)
+    output.mkdir(parents=True, exist_ok=True)
+    os.environ['TZ'] = 'Asia/Tokyo'
+    time.tzset()
+    os.environ.setdefault('TEST_EMAIL', 'simulation@localhost')
+    os.environ.setdefault('TRACE_EXPORTER', 'none')
+    os.environ.setdefault('WEBHOOK_SECRET', 'simulation')
+
+    if start is None:
+        start = JST.localize(datetime.combine(date.today() + timedelta(days=1), datetime.min.time()))
+    sim_clock = VirtualClock(start)
+    clock.install(sim_clock)
+
+    from seminar_automation_system import SeminarAutomationSystem
+    from seminar_scheduler import SeminarScheduler
+
+    system = SeminarAutomationSystem(db_path=str(output / 'seminar_automation.db'))
+    system.smtp = SmtpSink(output / 'mail.mbox')
+    system.slack = SlackSink(output / 'slack.jsonl')
+    receiver = WebhookReceiver(output / 'webhook.jsonl', system.webhook.secret, webhook_fail_rate, seed)
+    replay = ReplayAdapter(fixtures_dir)
+    system.fetcher.session.mount('http://', replay)
+    system.fetcher.session.mount('https://', replay)
+    if fixtures_dir and (Path(fixtures_dir) / 'subscribers.json').exists():
+        seed_subscribers(system.db_path, Path(fixtures_dir) / 'subscribers.json', receiver.url)
+
+    # 메인 프로세스 실패 주입 (재시도・운영 알림 경로 확인용)
+    rng = random.Random(seed)
+    injected = {'failures': 0}
+    main_process = system.main_process
+
+    def flaky_main_process(dry_run: bool = True):
+        if rng.random() < fail_rate:
+            injected['failures'] += 1
+            raise RuntimeError("simulated failure")
+        main_process(dry_run=dry_run)
+    system.main_process = flaky_main_process
+
+    schedule.clear()
+    scheduler = SeminarScheduler(system=system)
+    scheduler.setup_schedule(dry_run=dry_run)
+    for name in noop_jobs or []:
+        scheduler.executor.specs[name].fn = lambda *args: None
+    costs = JobCosts(sim_clock)
+    costs.wrap(scheduler.executor)
+    scheduler.executor.on_finish = sim_clock.notify
+
+    real_started = time.perf_counter()
+    try:
+        events = drive(sim_clock, scheduler.executor, start.timestamp() + days * 86400, outages or [])
+    finally:
+        scheduler.executor.shutdown(cancel=True)
+        system.smtp.close()
+        receiver.close()
+        clock.install(clock.SystemClock())
+
+    report = {
+        'start': start.isoformat(),
+        'end': sim_clock.now(JST).isoformat(),
+        'simulated_days': days,
+        'real_seconds': round(time.perf_counter() - real_started, 2),
+        'events': events,
+        'jobs': costs.summary(),
+        'executor': dict(scheduler.executor.stats),
+        'http': {'replayed': replay.hits, 'missing': replay.misses},
+        'mail_sent': system.smtp.sent,
+        'slack_sent': system.slack.sent,
+        'slack_api_calls': system.slack.api_calls,
+        'webhook': {**receiver.stats, 'sent': system.webhook.requests_sent, 'retried': system.webhook.retried},
+        'simulated_failures': injected['failures'],
+    }
+    with open(output / 'report.json', 'w', encoding='utf-8') as f:
+        json.dump(report, f, ensure_ascii=False, indent=2)
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description='海技士セミナー スケジュールシミュレーション（仮想時計）')
+    parser.add_argument('--days', type=float, default=28, help='シミュレーション日数')
+    parser.add_argument('--start', help='開始日時 JST（例: 2025-10-01T00:00、既定: 翌日0時）')
+    parser.add_argument('--fixtures', help='HTTPフィクスチャディレクトリ（index.json, subscribers.json）')
+    parser.add_argument('--output', default='./sim', help='DB・メール・レポートの出力先')
+    parser.add_argument('--dry-run', action='store_true', help='送信処理を通さない（既定はシンクへ送信）')
+    parser.add_argument('--fail-rate', type=float, default=0.0, help='メイン処理の失敗率 (0.0-1.0)')
+    parser.add_argument('--webhook-fail-rate', type=float, default=0.0, help='スタブ受信サーバーが503を返す割合 (0.0-1.0)')
+    parser.add_argument('--seed', type=int, default=0)
+    parser.add_argument('--outage', action='append', default=[], help='スケジューラー停止区間（例: 2025-10-03T05:00+8）')
+    parser.add_argument('--noop', default='', help='中身を実行しないジョブ（例: health）')
+    args = parser.parse_args()
+
+    logging.getLogger().setLevel(os.getenv('LOG_LEVEL', 'WARNING'))
+    start = JST.localize(datetime.fromisoformat(args.start)) if args.start else None
+    report = run_simulation(args.days, start, args.fixtures, args.output, args.dry_run, args.fail_rate,
+                            args.seed, [parse_outage(text) for text in args.outage],
+                            [name for name in args.noop.split(',') if name], args.webhook_fail_rate)
+    print(json.dumps(report, ensure_ascii=False, indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,529 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 저장소 규모 벤치마크
+Author: Manus AI
+Date: 2025-09-26
+
+수 년 분량의 합성 이력(기본: 세미나 100만 건・통지 로그 1,000만 건)으로 운영 스키마를 채우고,
+운영 코드의 조회・기록 메서드를 그대로 호출해 지연 시간을 측정한다. DB 파일 크기・테이블별 행 수・
+VACUUM 소요 시간과 각 SQL 의 실행 계획(전체 스캔 여부)도 함께 출력해, 색인이나 보존 기간 처리의
+회귀가 데이터 증가와 함께 드러나게 한다.
+
+- 생성(generate): 시드 고정 난수로 지역 편중・최근일수록 많은 증가 추세・09:00 정기 실행에 몰린
+  등록 시각・개최일 기준의 상태 분포・세미나당 통지 수와 실패율을 재현
+- 측정(run): DB 시각(가장 최근 created_at)에 맞춘 가상 시계로 "최근 24시간" 조회를 재현하고,
+  호출별 최솟값/p50/p95/최대(ms)와 실행 계획을 출력. 기준값(benchmarks/storage_baseline.json)이
+  있으면 같은 데이터 규모일 때만 비교해 새 전체 스캔이 생기거나 조회가 허용치를 넘게 느려지거나
+  DB 가 커지면 실패 (종료 코드 1)
+
+check_failures_and_notify_ops 는 발송 실패를 기록 시점에 메모리에서 판정하므로 DB 조회가 없다.
+대신 그 입력인 log_notification 의 기록 지연을 측정한다.
+
+사용 예:
+    python storage_benchmark.py generate --db /tmp/seminar_scale.db --years 5
+    python storage_benchmark.py run --db /tmp/seminar_scale.db
+    python storage_benchmark.py run --db /tmp/seminar_scale.db --save      # 기준값 갱신
+"""
+
+import os
+import sys
+import json
+import time
+import random
+import hashlib
+import sqlite3
+import argparse
+import platform
+from datetime import datetime, timedelta, timezone
+from pathlib import Path
+from typing import Callable, Dict, List, Tuple
+
+import pytz
+
+import clock
+from benchmark import BENCH_DIR, calibration_workload, measure, percentile
+from ics_feed import CalendarFeeds, render_vevent
+from runtime import Runtime
+from seminar_automation_system import SeminarAutomationSystem
+from seminar_config import SeminarConfig
+from snapshot_diff import SnapshotStore
+
+JST = pytz.timezone('Asia/Tokyo')
+
+BASELINE_PATH = BENCH_DIR / 'storage_baseline.json'
+CORPUS_PATH = BENCH_DIR / 'corpus.json'
+
+BATCH_SIZE = 50000
+
+# 지역별 세미나 비율 (관동・근기・구주에 편중)
+REGION_WEIGHTS = {
+    '관동': 22, '근기': 14, '구주': 12, '고베': 10, '중부': 10,
+    '중국': 8, '사국': 7, '동북': 7, '북해도': 6, '북륙신월': 4,
+}
+
+UPCOMING_STATUSES = (('募集中', 50), ('開催予定', 20), ('募集予定', 15), ('募集締切', 10), ('その他', 5))
+PAST_STATUSES = (('開催終了', 60), ('募集期限切れ', 25), ('その他', 10), ('中止', 5))
+
+NOTIFICATION_ERRORS = (
+    'SMTPServerDisconnected: Connection unexpectedly closed',
+    'SMTPRecipientsRefused: 550 5.1.1 User unknown',
+    'Slack API error: rate_limited',
+    'timeout: The read operation timed out',
+)
+
+# 기록 계열은 지연의 대부분이 저장 장치의 fsync 이므로 참고값으로만 비교
+WRITE_CASES = {'save_seminar', 'log_notification'}
+
+SQL_TIMESTAMP = '%Y-%m-%d %H:%M:%S'  # CURRENT_TIMESTAMP 과 같은 형식 (UTC)
+
+
+def weighted(rng: random.Random, choices) -> str:
+    values, weights = zip(*choices)
+    return rng.choices(values, weights)[0]
+
+
+def created_times(rng: random.Random, count: int, now: datetime, years: float) -> List[datetime]:
+    """등록 시각: 최근일수록 많고(증가 추세), 대부분 09:00 JST(00:00 UTC) 정기 실행 직후"""
+    span_days = int(years * 365)
+    times = []
+    for _ in range(count):
+        day = now.date() - timedelta(days=int(span_days * (1 - rng.random() ** 0.7)))
+        if rng.random() < 0.8:
+            seconds = rng.randint(0, 1800)
+        else:
+            seconds = rng.randint(0, 86399)
+        times.append(min(datetime(day.year, day.month, day.day) + timedelta(seconds=seconds), now))
+    times.sort()
+    return times
+
+
+def generate(db_path: str, seminars: int, notifications: int, subscribers: int,
+             years: float, seed: int, config_dir: str):
+    """운영 스키마에 합성 이력 투입 (기존 파일은 덮어씀)"""
+    rng = random.Random(seed)
+    now = datetime.now(timezone.utc).replace(tzinfo=None, microsecond=0)
+    for path in (db_path, db_path + '-journal', db_path + '-wal'):
+        if os.path.exists(path):
+            os.remove(path)
+    os.makedirs(os.path.dirname(db_path) or '.', exist_ok=True)
+
+    system = SeminarAutomationSystem.__new__(SeminarAutomationSystem)
+    system.runtime = Runtime.current()
+    system.db_path = db_path
+    system.setup_database()
+
+    with open(CORPUS_PATH, 'r', encoding='utf-8') as f:
+        titles = [title for title in json.load(f)['bureau_titles'] if 'セミナー' in title or '説明会' in title]
+    places = [place for place in json.load(open(os.path.join(config_dir, 'gazetteer.json'), encoding='utf-8'))
+              if place.get('kind') == 'port']
+
+    conn = sqlite3.connect(db_path)
+    conn.execute('PRAGMA journal_mode=OFF')  # 생성 중에만 (운영 DB 는 기본 설정)
+    conn.execute('PRAGMA synchronous=OFF')
+    region_ids = dict(conn.execute('SELECT name, region_id FROM regions').fetchall())
+    region_choices = [(region_ids[name], weight) for name, weight in REGION_WEIGHTS.items()]
+    started = time.perf_counter()
+
+    # 구독자・라우팅・근접 구독・캘린더 토큰
+    routes: List[Tuple[str, str]] = []
+    with conn:
+        for subscriber_id in range(1, subscribers + 1):
+            conn.execute('INSERT INTO subscribers (subscriber_id, name, region_id) VALUES (?, ?, ?)',
+                         (subscriber_id, f'船社{subscriber_id:05d}', weighted(rng, region_choices)))
+            address = f'crew{subscriber_id:05d}@example.jp'
+            conn.execute('INSERT INTO subscriber_routing (subscriber_id, channel, address) VALUES (?, ?, ?)',
+                         (subscriber_id, 'email', address))
+            routes.append(('email', address))
+            if rng.random() < 0.3:
+                webhook = f'https://hooks.slack.com/services/T000/B{subscriber_id:05d}/bench'
+                conn.execute('INSERT INTO subscriber_routing (subscriber_id, channel, address) VALUES (?, ?, ?)',
+                             (subscriber_id, 'slack', webhook))
+                routes.append(('slack', webhook))
+            if rng.random() < 0.1:
+                conn.execute('INSERT INTO subscriber_proximity (subscriber_id, place, radius_km) VALUES (?, ?, ?)',
+                             (subscriber_id, rng.choice(places)['name'], rng.choice((30.0, 50.0, 100.0))))
+            if rng.random() < 0.3:
+                conn.execute('INSERT INTO subscriber_calendars (subscriber_id, token) VALUES (?, ?)',
+                             (subscriber_id, f'bench-{subscriber_id:05d}'))
+
+    # 세미나・회장 좌표・캘린더 조각
+    seminar_rows, region_rows, venue_rows, vevent_rows = [], [], [], []
+    created = created_times(rng, seminars, now, years)
+
+    def flush_seminars():
+        with conn:
+            conn.executemany('''
+                INSERT INTO seminars (seminar_id, region_id, title, event_date, location, status, source_url,
+                                      raw_text, hash, created_at, updated_at)
+                VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+            ''', seminar_rows)
+            conn.executemany('INSERT INTO seminar_regions (seminar_id, region_id) VALUES (?, ?)', region_rows)
+            conn.executemany('INSERT INTO seminar_venues (seminar_id, place, latitude, longitude) VALUES (?, ?, ?, ?)',
+                             venue_rows)
+            conn.executemany('INSERT INTO seminar_vevents (seminar_id, fragment, fragment_hash, rendered_at) '
+                             'VALUES (?, ?, ?, ?)', vevent_rows)
+        seminar_rows.clear()
+        region_rows.clear()
+        venue_rows.clear()
+        vevent_rows.clear()
+
+    for index, created_at in enumerate(created):
+        seminar_id = index + 1
+        place = rng.choice(places)
+        event_date = (created_at + timedelta(days=rng.randint(7, 120))).date() if rng.random() < 0.9 else None
+        upcoming = event_date is None or event_date >= now.date()
+        status = weighted(rng, UPCOMING_STATUSES if upcoming else PAST_STATUSES)
+        title = f"{rng.choice(titles)} 第{seminar_id}回"
+        source_url = f'https://bench.example.jp/seminar/{seminar_id}.html'
+        stamp = created_at.strftime(SQL_TIMESTAMP)
+        seminar = {
+            'seminar_id': seminar_id, 'title': title, 'status': status, 'source_url': source_url,
+            'event_date': event_date.isoformat() if event_date else None, 'location': place['name'],
+            'created_at': stamp,
+        }
+        region_id = weighted(rng, region_choices)
+        region_rows.append((seminar_id, region_id))
+        seminar_rows.append((seminar_id, region_id, title, seminar['event_date'], place['name'],
+                             status, source_url, f"{title}\n会場: {place['name']}\n{source_url}",
+                             hashlib.sha256(source_url.encode('utf-8')).hexdigest(), stamp, stamp))
+        if rng.random() < 0.7:
+            seminar.update(latitude=place['lat'] + rng.uniform(-0.05, 0.05),
+                           longitude=place['lon'] + rng.uniform(-0.05, 0.05))
+            venue_rows.append((seminar_id, place['name'], seminar['latitude'], seminar['longitude']))
+        if event_date:
+            fragment = render_vevent(seminar)
+            vevent_rows.append((seminar_id, fragment, hashlib.sha1(fragment.encode('utf-8')).hexdigest(), stamp))
+        if len(seminar_rows) >= BATCH_SIZE:
+            flush_seminars()
+    flush_seminars()
+    print(f"セミナー {seminars:,}件 投入 ({time.perf_counter() - started:.0f}秒)")
+
+    # 통지 로그: 세미나 등록 직후에 구독자 수만큼 (발송 시각 순 = notification_id 순)
+    per_seminar, remainder = divmod(notifications, max(seminars, 1))
+    extra = set(rng.sample(range(seminars), remainder)) if seminars else set()
+    rows = []
+    for index, created_at in enumerate(created):
+        for _ in range(per_seminar + (index in extra)):
+            channel, address = rng.choice(routes)
+            failed = rng.random() < 0.03
+            rows.append((index + 1, channel, address, 'fail' if failed else 'ok',
+                         (created_at + timedelta(seconds=rng.randint(1, 600))).strftime(SQL_TIMESTAMP),
+                         rng.choice(NOTIFICATION_ERRORS) if failed else None))
+        if len(rows) >= BATCH_SIZE:
+            with conn:
+                conn.executemany('INSERT INTO seminar_notifications (seminar_id, channel, address, status, sent_at, error) '
+                                 'VALUES (?, ?, ?, ?, ?, ?)', rows)
+            rows.clear()
+    with conn:
+        conn.executemany('INSERT INTO seminar_notifications (seminar_id, channel, address, status, sent_at, error) '
+                         'VALUES (?, ?, ?, ?, ?, ?)', rows)
+    print(f"通知ログ {notifications:,}件 投入 ({time.perf_counter() - started:.0f}秒)")
+
+    # 정보원 스냅샷 (지방운수국 페이지 수 × 페이지당 항목 수)
+    with conn:
+        for page in range(60):
+            url = f'https://bench.example.jp/bureau/{page}/news.html'
+            conn.execute('INSERT INTO source_snapshots (url, config_fingerprint, item_count) VALUES (?, ?, ?)',
+                         (url, 'bench', 300))
+            conn.executemany('INSERT INTO source_items (url, item_key, fingerprint) VALUES (?, ?, ?)',
+                             [(url, f'/news/{page}/{item}.html', f'{rng.getrandbits(160):040x}') for item in range(300)])
+
+    conn.execute('PRAGMA journal_mode=DELETE')
+    conn.close()
+    print(f"生成完了: {db_path} ({os.path.getsize(db_path) / 1024 / 1024:.0f}MB, "
+          f"{time.perf_counter() - started:.0f}秒)")
+
+
+class PlanRecorder:
+    """측정 대상 메서드가 여는 연결의 SQL 을 기록 (바인드 값이 전개된 문장)"""
+
+    def __init__(self):
+        self.statements: List[str] = []
+        self._connect = sqlite3.connect
+
+    def __enter__(self):
+        def connect(*args, **kwargs):
+            conn = self._connect(*args, **kwargs)
+            conn.set_trace_callback(self.statements.append)
+            return conn
+        sqlite3.connect = connect
+        return self
+
+    def __exit__(self, *exc):
+        sqlite3.connect = self._connect
+
+    def plans(self, db_path: str) -> List[Tuple[str, List[str]]]:
+        conn = self._connect(db_path)
+        try:
+            result = []
+            for statement in self.statements:
+                if statement.split(None, 1)[0].upper() not in ('SELECT', 'INSERT', 'UPDATE', 'DELETE'):
+                    continue
+                plan = [row[3] for row in conn.execute('EXPLAIN QUERY PLAN ' + statement)]
+                result.append((' '.join(statement.split()), plan))
+            return result
+        finally:
+            conn.close()
+
+
+def full_scans(plan: List[str]) -> List[str]:
+    return [step for step in plan if step.startswith('SCAN') and 'INDEX' not in step]
+
+
+def build_cases(system: SeminarAutomationSystem, conn: sqlite3.Connection,
+                rng: random.Random) -> List[Tuple[str, Callable[[int], object]]]:
+    """운영 메서드 호출 (인수는 호출 번호로 결정)"""
+    regions = list(REGION_WEIGHTS)
+    recent_hashes = [row[0] for row in conn.execute('SELECT hash FROM seminars ORDER BY seminar_id DESC LIMIT 100')]
+    subscriber_ids = [row[0] for row in conn.execute('SELECT subscriber_id FROM subscribers')]
+    tokens = [row[0] for row in conn.execute('SELECT token FROM subscriber_calendars')]
+    urls = [row[0] for row in conn.execute('SELECT url FROM source_snapshots')]
+    run_id = f'{time.time_ns():x}'
+
+    def duplicated(i):
+        # 신규 항목(대부분)과 직전 실행에서 저장된 항목을 번갈아 판정
+        if i % 2:
+            return system.is_duplicated(rng.choice(recent_hashes))
+        return system.is_duplicated(hashlib.sha256(f'{run_id}-{i}'.encode('utf-8')).hexdigest())
+
+    def feed(i):
+        system.calendar._cache.clear()  # 조각 조립까지 측정
+        return system.calendar.feed(tokens[i % len(tokens)])
+
+    def save(i):
+        url = f'https://bench.example.jp/new/{run_id}/{i}.html'
+        return system.save_seminar({
+            'region': regions[i % len(regions)], 'title': f'めざせ！海技者セミナー 計測{i}',
+            'event_date': (clock.now(JST) + timedelta(days=30)).date().isoformat(), 'location': '神戸',
+            'status': '募集中', 'source_url': url, 'raw_text': url,
+            'hash': hashlib.sha256(url.encode('utf-8')).hexdigest(),
+        })
+
+    def notify(i):
+        return system.log_notification(i + 1, 'email', f'crew{i:05d}@example.jp', 'fail' if i % 30 == 0 else 'ok',
+                                       'SMTPServerDisconnected' if i % 30 == 0 else None)
+
+    cases = [
+        ('is_duplicated', duplicated),
+        ('get_new_important_seminars_by_region', lambda i: system.get_new_important_seminars_by_region(regions[i % len(regions)])),
+        ('get_recent_seminars', lambda i: system.get_recent_seminars(limit=5)),
+        ('get_subscribers_by_region', lambda i: system.get_subscribers_by_region(regions[i % len(regions)])),
+        ('get_routing_info', lambda i: system.get_routing_info(rng.choice(subscriber_ids))),
+        ('snapshot_load', lambda i: system.snapshots.load(urls[i % len(urls)])),
+        ('save_seminar', save),
+        ('log_notification', notify),
+    ]
+    if tokens:
+        cases.insert(5, ('calendar_feed', feed))
+    return cases
+
+
+def table_stats(conn: sqlite3.Connection) -> Dict[str, Dict]:
+    tables = [row[0] for row in conn.execute(
+        "SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' ORDER BY name")]
+    stats = {table: {'rows': conn.execute(f'SELECT COUNT(*) FROM "{table}"').fetchone()[0]} for table in tables}
+    try:
+        # 색인을 포함한 테이블별 크기 (dbstat 가상 테이블이 없는 빌드는 생략)
+        for name, table, size in conn.execute('''
+            SELECT d.name, COALESCE(m.tbl_name, d.name), SUM(d.pgsize) FROM dbstat d
+            LEFT JOIN sqlite_master m ON m.name = d.name GROUP BY d.name
+        '''):
+            if table in stats:
+                stats[table]['mb'] = round(stats[table].get('mb', 0.0) + size / 1024 / 1024, 1)
+    except sqlite3.OperationalError:
+        pass
+    return stats
+
+
+def storage(db_path: str, vacuum: bool) -> Dict:
+    """DB 파일 크기・테이블별 행 수・VACUUM 소요 시간"""
+    conn = sqlite3.connect(db_path)
+    try:
+        page_size = conn.execute('PRAGMA page_size').fetchone()[0]
+        result = {
+            'size_mb': round(os.path.getsize(db_path) / 1024 / 1024, 1),
+            'free_mb': round(conn.execute('PRAGMA freelist_count').fetchone()[0] * page_size / 1024 / 1024, 1),
+            'tables': table_stats(conn),
+            'indexes': [row[0] for row in conn.execute(
+                "SELECT name FROM sqlite_master WHERE type = 'index' ORDER BY name")],
+        }
+        if vacuum:
+            started = time.perf_counter()
+            conn.execute('VACUUM')
+            result['vacuum_seconds'] = round(time.perf_counter() - started, 2)
+            result['size_after_vacuum_mb'] = round(os.path.getsize(db_path) / 1024 / 1024, 1)
+        return result
+    finally:
+        conn.close()
+
+
+def run(db_path: str, rounds: int, config_dir: str, seed: int, vacuum: bool) -> Dict:
+    """운영 메서드별 지연 측정・실행 계획・저장소 지표"""
+    conn = sqlite3.connect(db_path)
+    latest = conn.execute('SELECT MAX(created_at) FROM seminars').fetchone()[0]
+    scale = {'seminars': conn.execute('SELECT MAX(seminar_id) FROM seminars').fetchone()[0] or 0,
+             'notifications': conn.execute('SELECT MAX(notification_id) FROM seminar_notifications').fetchone()[0] or 0}
+    conn.close()
+    if not latest:
+        raise SystemExit(f"セミナーがありません（generate で作成）: {db_path}")
+
+    # "최근 24시간" 조회가 생성 시점의 데이터를 대상으로 하도록 가상 시계를 DB 시각에 맞춤
+    clock.install(clock.VirtualClock(datetime.strptime(latest, SQL_TIMESTAMP).replace(tzinfo=timezone.utc)))
+
+    system = SeminarAutomationSystem.__new__(SeminarAutomationSystem)
+    system.runtime = Runtime.current()
+    system.db_path = db_path
+    system.config = SeminarConfig.load(config_dir)
+    system.calendar = CalendarFeeds(lambda: system.runtime.connect(db_path), lambda: system.config.gazetteer)
+    system.snapshots = SnapshotStore(lambda: system.runtime.connect(db_path))
+
+    calibration = measure(calibration_workload, [None] * 50, rounds=10, inner=20)['min_ns']
+    rng = random.Random(seed)
+    conn = sqlite3.connect(db_path)
+    cases = build_cases(system, conn, rng)
+    conn.close()
+
+    results, plans = {}, {}
+    print(f"{'query':<38} {'first':>8} {'min':>8} {'p50':>8} {'p95':>8} {'max':>8}  (ms, {rounds}回)")
+    for name, fn in cases:
+        with PlanRecorder() as recorder:
+            started = time.perf_counter()
+            fn(0)
+            first = (time.perf_counter() - started) * 1000
+        plans[name] = recorder.plans(db_path)
+
+        samples = []
+        for i in range(1, rounds + 1):
+            started = time.perf_counter()
+            fn(i)
+            samples.append((time.perf_counter() - started) * 1000)
+        samples.sort()
+        results[name] = {'first_ms': round(first, 2), 'min_ms': round(samples[0], 2), 'p50_ms': round(percentile(samples, 0.50), 2),
+                         'p95_ms': round(percentile(samples, 0.95), 2), 'max_ms': round(samples[-1], 2)}
+        result = results[name]
+        print(f"{name:<38} {result['first_ms']:>8.2f} {result['min_ms']:>8.2f} {result['p50_ms']:>8.2f} {result['p95_ms']:>8.2f} "
+              f"{result['max_ms']:>8.2f}")
+
+    print("\n実行計画 (SCAN = 全件走査)")
+    for name, statements in plans.items():
+        for statement, plan in statements:
+            marker = '  ← 全件走査' if full_scans(plan) else ''
+            print(f"  [{name}] {statement[:100]}{marker}")
+            for step in plan:
+                print(f"      {step}")
+
+    # 기록 계열 측정분을 되돌려 다음 실행에서도 같은 데이터 규모로 비교
+    conn = sqlite3.connect(db_path)
+    with conn:
+        conn.execute("DELETE FROM seminar_vevents WHERE seminar_id > ?", (scale['seminars'],))
+        conn.execute("DELETE FROM seminars WHERE seminar_id > ?", (scale['seminars'],))
+        conn.execute("DELETE FROM seminar_notifications WHERE notification_id > ?", (scale['notifications'],))
+    conn.close()
+
+    stats = storage(db_path, vacuum)
+    print(f"\nDBファイル: {stats['size_mb']:.1f}MB (空き {stats['free_mb']:.1f}MB), 索引 {len(stats['indexes'])}個")
+    for table, info in stats['tables'].items():
+        print(f"  {table:<24} {info['rows']:>12,}行 {info.get('mb', 0.0):>10.1f}MB")
+    if vacuum:
+        print(f"VACUUM: {stats['vacuum_seconds']:.1f}秒 → {stats['size_after_vacuum_mb']:.1f}MB")
+
+    return {'saved_at': datetime.now(JST).isoformat(timespec='seconds'), 'python': platform.python_version(),
+            'sqlite': sqlite3.sqlite_version, 'machine': platform.machine(), 'rounds': rounds,
+            'calibration_ns': calibration, 'scale': scale, 'results': results, 'storage': stats,
+            'plans': {name: [plan for _, plan in statements] for name, statements in plans.items()}}
+
+
+def compare(report: Dict, baseline: Dict, tolerance: float, min_delta_ms: float) -> List[str]:
+    """기준값 대비 나빠진 항목 목록
+    - 조회: 새 전체 스캔, 또는 보정한 최솟값이 tolerance 와 min_delta_ms 를 모두 넘게 느려짐
+    - 저장소: DB 크기・VACUUM 시간이 tolerance 를 넘게 증가
+    """
+    if report['scale'] != baseline['scale']:
+        print(f"\nデータ規模が基準値と異なるため比較しません (基準 {baseline['scale']}, 今回 {report['scale']})")
+        return []
+
+    scale = report['calibration_ns'] / baseline['calibration_ns']
+    regressions = []
+    print(f"\n基準値との比較 (基準 {baseline['saved_at']}, 計測環境補正 x{scale:.2f}, 許容 +{tolerance:.0%})")
+    for name, result in report['results'].items():
+        base = baseline['results'].get(name)
+        if base is None:
+            continue
+        # 서브 밀리초 조회는 측정 잡음이 크므로 최솟값과 절대 증가량으로 판정
+        expected = base['min_ms'] * scale
+        ratio = result['min_ms'] / expected if expected else 1.0
+        regressed = (name not in WRITE_CASES and ratio > 1 + tolerance
+                     and result['min_ms'] - expected > min_delta_ms)
+        new_scans = sorted({step for plan in report['plans'].get(name, []) for step in full_scans(plan)}
+                           - {step for plan in baseline['plans'].get(name, []) for step in full_scans(plan)})
+        if regressed or new_scans:
+            regressions.append(name)
+        note = '  ← 回帰' if regressed else '  (参考)' if name in WRITE_CASES else ''
+        print(f"  {name:<38} {expected:>8.2f} → {result['min_ms']:>8.2f} ms  {ratio - 1:+7.1%}{note}")
+        for step in new_scans:
+            print(f"      新たな全件走査: {step}")
+
+    # 크기는 같은 시드・규모라면 스키마・색인 변경에만 좌우되므로 보정하지 않음
+    for key, scaled in (('size_mb', False), ('vacuum_seconds', True)):
+        if key not in report['storage'] or key not in baseline['storage']:
+            continue
+        base = baseline['storage'][key] * (scale if scaled else 1.0)
+        ratio = report['storage'][key] / base if base else 1.0
+        regressed = ratio > 1 + tolerance
+        if regressed:
+            regressions.append(key)
+        print(f"  {key:<38} {base:>8.1f} → {report['storage'][key]:>8.1f}     "
+              f"{ratio - 1:+7.1%}{'  ← 回帰' if regressed else ''}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='合成履歴による保存領域規模のベンチマーク')
+    parser.add_argument('command', choices=('generate', 'run'))
+    parser.add_argument('--db', default=os.getenv('STORAGE_BENCH_DB', '/tmp/seminar_scale.db'))
+    parser.add_argument('--config-dir', default=os.getenv('CONFIG_DIR', str(Path(__file__).resolve().parent / 'config')))
+    parser.add_argument('--seed', type=int, default=42)
+    parser.add_argument('--seminars', type=int, default=1000000)
+    parser.add_argument('--notifications', type=int, default=10000000)
+    parser.add_argument('--subscribers', type=int, default=5000)
+    parser.add_argument('--years', type=float, default=5.0)
+    parser.add_argument('--rounds', type=int, default=int(os.getenv('STORAGE_BENCH_ROUNDS', '20')))
+    parser.add_argument('--no-vacuum', action='store_true', help='VACUUM 時間を計測しない')
+    parser.add_argument('--save', action='store_true', help='結果を基準値として保存')
+    parser.add_argument('--tolerance', type=float, default=float(os.getenv('BENCH_TOLERANCE', '0.5')),
+                        help='許容する悪化率')
+    parser.add_argument('--min-delta-ms', type=float, default=float(os.getenv('STORAGE_BENCH_MIN_DELTA_MS', '1.0')),
+                        help='回帰とみなす最小の遅延増加（ms）')
+    parser.add_argument('--json', help='結果をJSONで出力するパス')
+    args = parser.parse_args()
+
+    if args.command == 'generate':
+        generate(args.db, args.seminars, args.notifications, args.subscribers, args.years, args.seed, args.config_dir)
+        return
+
+    report = run(args.db, args.rounds, args.config_dir, args.seed, not args.no_vacuum)
+    if args.json:
+        with open(args.json, 'w', encoding='utf-8') as f:
+            json.dump(report, f, ensure_ascii=False, indent=2)
+
+    if args.save:
+        with open(BASELINE_PATH, 'w', encoding='utf-8') as f:
+            json.dump(report, f, ensure_ascii=False, indent=2)
+            f.write('\n')
+        print(f"\n基準値を保存しました: {BASELINE_PATH}")
+        return
+
+    if not BASELINE_PATH.exists():
+        print(f"\n基準値がありません（--save で作成）: {BASELINE_PATH}")
+        return
+    with open(BASELINE_PATH, 'r', encoding='utf-8') as f:
+        baseline = json.load(f)
+    regressions = compare(report, baseline, args.tolerance, args.min_delta_ms)
+    if regressions:
+        print(f"\n性能回帰: {', '.join(regressions)}", file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
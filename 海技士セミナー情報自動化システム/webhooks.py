@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+해기사 세미나 자동화 시스템 - 발신 Webhook 채널 (시스템 간 연계)
+Author: Manus AI
+Date: 2025-09-26
+
+구독자 라우팅의 channel='webhook' 주소(엔드포인트 URL)로 신착 항목을 JSON 으로 POST 한다.
+- 1회 실행의 발송(지역 요약・근접 통지)을 엔드포인트별로 모아 WEBHOOK_BATCH_SIZE 건씩 1요청으로 보냄
+  (같은 항목이 여러 주제로 가면 1건으로 합치고 topics 에 나열)
+- HMAC-SHA256 서명: X-Seminar-Signature: sha256=hex(HMAC(WEBHOOK_SECRET, "<timestamp>.<body>"))
+  (WEBHOOK_SECRET 이 없으면 서명 없는 POST 를 보내지 않고 실패로 처리)
+- 지속 HTTP 연결 풀, 엔드포인트별 동시 요청 상한(WEBHOOK_CONCURRENCY)
+- 429・5xx・연결 오류는 지수 백오프로 재시도 (Retry-After 우선), 그 외 4xx 는 즉시 실패
+- 재시도해도 X-Seminar-Delivery(배치 ID)는 같으므로 수신 측에서 중복 제거 가능
+
+요청 본문:
+    {"delivery_id": "...", "sent_at": "2025-10-01T09:00:00+09:00", "tenant": null,
+     "batch": {"index": 1, "count": 1},
+     "items": [{"seminar_id": 1, "title": "...", "status": "募集中", "event_date": "2025-11-10",
+                "location": "東京", "source_url": "https://...", "topics": ["관동"]}]}
+"""
+
+import os
+import hmac
+import json
+import uuid
+import random
+import hashlib
+import logging
+import threading
+from collections import OrderedDict
+from concurrent.futures import ThreadPoolExecutor
+from typing import Callable, Dict, List, Optional, Tuple
+
+import pytz
+import requests
+from requests.adapters import HTTPAdapter
+
+import clock
+
+logger = logging.getLogger(__name__)
+
+JST = pytz.timezone('Asia/Tokyo')
+
+SIGNATURE_HEADER = 'X-Seminar-Signature'
+TIMESTAMP_HEADER = 'X-Seminar-Timestamp'
+DELIVERY_HEADER = 'X-Seminar-Delivery'
+
+
+def sign(secret: str, timestamp: str, body: bytes) -> str:
+    """요청 서명 (수신 측은 같은 계산으로 검증)"""
+    digest = hmac.new(secret.encode('utf-8'), timestamp.encode('ascii') + b'.' + body, hashlib.sha256).hexdigest()
+    return f"sha256={digest}"
+
+
+class WebhookSender:
+    """Webhook POST (연결 풀 재사용, 엔드포인트별 동시성 상한, 백오프 재시도)"""
+
+    def __init__(self):
+        self.secret = os.getenv('WEBHOOK_SECRET', '')
+        self.timeout = float(os.getenv('REQUEST_TIMEOUT', '30'))
+        self.batch_size = int(os.getenv('WEBHOOK_BATCH_SIZE', '100'))
+        self.concurrency = int(os.getenv('WEBHOOK_CONCURRENCY', '2'))
+        self.workers = int(os.getenv('WEBHOOK_WORKERS', '4'))
+        self.retries = int(os.getenv('WEBHOOK_RETRIES', '3'))
+        self.backoff = float(os.getenv('WEBHOOK_BACKOFF_SECONDS', '2'))
+        self.max_backoff = float(os.getenv('WEBHOOK_MAX_BACKOFF_SECONDS', '60'))
+        self.requests_sent = 0
+        self.retried = 0
+        self._slots: Dict[str, threading.Semaphore] = {}
+        self._lock = threading.Lock()
+
+        self.session = requests.Session()
+        adapter = HTTPAdapter(pool_maxsize=max(self.workers, self.concurrency))
+        self.session.mount('http://', adapter)
+        self.session.mount('https://', adapter)
+
+    def slot_for(self, url: str) -> threading.Semaphore:
+        with self._lock:
+            slot = self._slots.get(url)
+            if slot is None:
+                slot = self._slots[url] = threading.Semaphore(self.concurrency)
+            return slot
+
+    def post(self, url: str, payload: Dict) -> Tuple[bool, Optional[str]]:
+        """JSON POST (2xx 면 성공), 재시도 대기는 동시성 슬롯을 놓은 상태에서 수행"""
+        if not self.secret:
+            # 수신 측이 위조 요청과 구별할 수 없으므로 서명 없이는 보내지 않음
+            logger.error(f"WEBHOOK_SECRET が未設定のため署名なしのWebhookは送信しません: {url}")
+            return False, 'WEBHOOK_SECRET 미설정 (서명 없는 발송 거부)'
+
+        body = json.dumps(payload, ensure_ascii=False, separators=(',', ':')).encode('utf-8')
+        error = None
+        for attempt in range(self.retries + 1):
+            timestamp = str(int(clock.time()))
+            headers = {'Content-Type': 'application/json; charset=utf-8',
+                       DELIVERY_HEADER: payload.get('delivery_id', ''),
+                       TIMESTAMP_HEADER: timestamp,
+                       SIGNATURE_HEADER: sign(self.secret, timestamp, body)}
+
+            retry_after = None
+            with self.slot_for(url):
+                try:
+                    with self._lock:
+                        self.requests_sent += 1
+                    response = self.session.post(url, data=body, headers=headers, timeout=self.timeout)
+                except requests.RequestException as e:
+                    error = str(e)
+                else:
+                    if 200 <= response.status_code < 300:
+                        return True, None
+                    error = f"Webhook 응답 {response.status_code}"
+                    if response.status_code != 429 and response.status_code < 500:
+                        return False, error
+                    try:
+                        retry_after = float(response.headers['Retry-After'])
+                    except (KeyError, ValueError):
+                        pass
+
+            if attempt < self.retries:
+                delay = retry_after if retry_after is not None else self.backoff * 2 ** attempt * random.uniform(0.5, 1.0)
+                delay = min(delay, self.max_backoff)
+                logger.warning(f"Webhook 재시도 {attempt + 1}/{self.retries}: {url} ({error}, {delay:.1f}초 후)")
+                with self._lock:
+                    self.retried += 1
+                clock.sleep(delay)
+        return False, error
+
+
+class WebhookOutbox:
+    """실행 중 Webhook 발송을 엔드포인트별로 모아 실행 끝에 일괄 발송"""
+
+    def __init__(self, sender: Callable[[], WebhookSender], tenant: Optional[str] = None):
+        self.sender = sender  # 시뮬레이션 등에서 발송 계층을 교체해도 반영되도록 호출 시점에 취득
+        self.tenant = tenant
+        # 엔드포인트 → URL → 항목 (topics 누적)
+        self._pending: Dict[str, 'OrderedDict[str, Dict]'] = {}
+        # 엔드포인트 → 오류 (모든 배치 성공이면 None), 대기 발송의 최종 결과 확인용 (take_outcomes)
+        self.outcomes: Dict[str, Optional[str]] = {}
+        self._lock = threading.Lock()
+
+    def add(self, address: str, topic: Optional[str], seminars: List[Dict]):
+        with self._lock:
+            items = self._pending.setdefault(address, OrderedDict())
+            for seminar in seminars:
+                item = items.get(seminar['source_url'])
+                if item is None:
+                    item = items[seminar['source_url']] = self._item(seminar)
+                if topic and topic not in item['topics']:
+                    item['topics'].append(topic)
+
+    def flush(self) -> Tuple[int, int]:
+        """대기분 발송 → (성공 요청 수, 실패 요청 수)"""
+        with self._lock:
+            pending, self._pending = self._pending, {}
+        if not pending:
+            return 0, 0
+
+        sender = self.sender()
+        sent_at = clock.now(JST).isoformat()
+        batches = []
+        for address, items in pending.items():
+            values = list(items.values())
+            chunks = [values[start:start + sender.batch_size] for start in range(0, len(values), sender.batch_size)]
+            for index, chunk in enumerate(chunks, 1):
+                batches.append((address, {
+                    'delivery_id': uuid.uuid4().hex,
+                    'sent_at': sent_at,
+                    'tenant': self.tenant,
+                    'batch': {'index': index, 'count': len(chunks)},
+                    'items': chunk,
+                }))
+
+        # 엔드포인트 간은 병렬, 같은 엔드포인트는 WEBHOOK_CONCURRENCY 까지
+        with ThreadPoolExecutor(max_workers=max(1, min(sender.workers, len(batches)))) as pool:
+            results = list(pool.map(lambda batch: sender.post(*batch), batches))
+
+        ok = failed = 0
+        outcomes = dict.fromkeys(pending)
+        for (address, payload), (success, error) in zip(batches, results):
+            if success:
+                ok += 1
+            else:
+                failed += 1
+                outcomes[address] = outcomes[address] or error or 'Webhook 발송 실패'
+                logger.error(f"Webhook送信失敗: {address} ({len(payload['items'])}件) - {error}")
+        with self._lock:
+            for address, error in outcomes.items():
+                if self.outcomes.get(address) is None:
+                    self.outcomes[address] = error
+        logger.info(f"Webhook送信: {len(pending)}エンドポイント・{sum(len(items) for items in pending.values())}件 → "
+                    f"{len(batches)}リクエスト (成功{ok}・失敗{failed})")
+        return ok, failed
+
+    def take_outcomes(self) -> Dict[str, Optional[str]]:
+        """지금까지 발송한 엔드포인트별 결과를 꺼내고 초기화"""
+        with self._lock:
+            outcomes, self.outcomes = self.outcomes, {}
+        return outcomes
+
+    @staticmethod
+    def _item(seminar: Dict) -> Dict:
+        event_date = seminar.get('event_date')
+        if event_date and not isinstance(event_date, str):
+            event_date = event_date.strftime('%Y-%m-%d')
+        return {
+            'seminar_id': seminar.get('seminar_id'),
+            'title': seminar['title'],
+            'status': seminar['status'],
+            'event_date': event_date[:10] if event_date else None,
+            'location': seminar.get('location'),
+            'source_url': seminar['source_url'],
+            'topics': [],
+        }